@@ -4,10 +4,11 @@ set -euo pipefail
 show_help () {
     echo
     echo "To run a day: ./$(basename $0) 24day1"
+    echo "To run many days in one process: ./$(basename $0) all | 1-5 | 3 ..."
     echo
 }
 
-if [[ $# -ne 1 ]]; then
+if [[ $# -lt 1 ]]; then
     show_help
     exit 1
 fi
@@ -15,5 +16,10 @@ fi
 DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
 cd $DIR
 
-make bin/$1
-./bin/$1 data/$1.txt
+if [[ $# -eq 1 && $1 == 24day* ]]; then
+    make bin/$1
+    ./bin/$1 data/$1.txt
+else
+    make bin/aoc
+    ./bin/aoc "$@"
+fi
@@ -0,0 +1,156 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "arena.h"
+#include "common.h"
+#include "parallel.h"
+#include "solution.h"
+
+/**
+ * Result of running one day.
+ */
+struct DayResult {
+    int day;
+    std::unique_ptr<aoc::Solution> (*make)(std::pmr::memory_resource*);
+    std::string filename;
+    bool has_input = false;
+    aoc::Answers answers;
+    std::vector<std::string> warnings;
+    double seconds = 0;
+};
+
+/**
+ * Parse a selection of days, i.e. "all", a single day "N", or a range "A-B".
+ * Adds the selected days to `days`.
+ * @returns False if the selection is malformed
+ */
+bool parse_days(const char* arg, std::vector<int>& days)
+{
+    if (std::strcmp(arg, "all") == 0) {
+        for (const auto& registered : aoc::registry()) {
+            days.push_back(registered.day);
+        }
+        return true;
+    }
+
+    char* end;
+    const long first = std::strtol(arg, &end, 10);
+    long last = first;
+    if (*end == '-') {
+        last = std::strtol(end + 1, &end, 10);
+    }
+    if (end == arg || *end != '\0' || first > last) {
+        return false;
+    }
+
+    for (long day = first; day <= last; ++day) {
+        days.push_back(day);
+    }
+    return true;
+}
+
+/**
+ * Runs the solutions of many days in one process, concurrently.
+ *
+ * Usage: aoc [--threads N] [--bench N [--json]] [--memory BYTES] [--data DIR] [DAYS...]
+ *
+ * where each of DAYS is "all", a day "N", or a range of days "A-B". Runs all
+ * days if none are given. The input of day N is read from DIR/24dayN.txt,
+ * where DIR defaults to "data". With `--bench`, the days are benchmarked one
+ * after the other instead.
+ */
+int main(int argc, char** argv)
+{
+    aoc::RunOptions options;
+    argc = aoc::parse_run_options(argc, argv, options);
+
+    std::string data_dir = "data";
+    std::vector<int> days;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            data_dir = argv[++i];
+        } else if (!parse_days(argv[i], days)) {
+            fprintf(stderr, "Invalid selection of days '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (days.empty()) {
+        parse_days("all", days);
+    }
+
+    std::sort(days.begin(), days.end());
+    days.erase(std::unique(days.begin(), days.end()), days.end());
+
+    std::vector<DayResult> results;
+    for (const int day : days) {
+        const auto registered = std::find_if(aoc::registry().begin(), aoc::registry().end(),
+                                             [&](const aoc::RegisteredDay& r) { return r.day == day; });
+        if (registered == aoc::registry().end()) {
+            fprintf(stderr, "Day %d: no solution\n", day);
+            continue;
+        }
+        results.push_back({day, registered->make, data_dir + "/24day" + std::to_string(day) + ".txt"});
+    }
+
+    if (options.bench_reps > 0) {
+        // days are benchmarked one at a time, so that they do not compete for
+        // the cores
+        for (const auto& result : results) {
+            if (access(result.filename.c_str(), R_OK) != 0) {
+                fprintf(stderr, "Day %d: missing puzzle input '%s'\n", result.day, result.filename.c_str());
+                continue;
+            }
+            aoc::Arena arena;
+            const auto solution = result.make(arena.resource());
+            aoc::run_day(result.day, *solution, result.filename.c_str(), options);
+        }
+        return 0;
+    }
+
+    // each day runs as one task of the pool, so the days themselves run
+    // concurrently and their own parallel loops run sequentially
+    const auto start = std::chrono::steady_clock::now();
+    aoc::default_pool().run(results.size(), [&](std::size_t i) {
+        DayResult& result = results[i];
+        result.has_input = access(result.filename.c_str(), R_OK) == 0;
+        if (!result.has_input) {
+            return;
+        }
+
+        // each day has its own arena, as the arenas are not thread-safe
+        const auto day_start = std::chrono::steady_clock::now();
+        aoc::Arena arena;
+        const auto solution = result.make(arena.resource());
+        result.answers = aoc::solve(*solution, result.filename.c_str());
+        result.warnings = solution->warnings();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - day_start).count();
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& result : results) {
+        if (!result.has_input) {
+            fprintf(stderr, "Day %d: missing puzzle input '%s'\n", result.day, result.filename.c_str());
+            continue;
+        }
+        aoc::print_answers(result.day, result.answers);
+        aoc::print_warnings(result.day, result.warnings);
+    }
+
+    printf("\n");
+    for (const auto& result : results) {
+        if (result.has_input) {
+            printf("Day %d: %10.3f ms\n", result.day, 1e3 * result.seconds);
+        }
+    }
+    printf("Total: %10.3f ms wall, %d threads\n", 1e3 * seconds, aoc::num_threads());
+
+    return 0;
+}
@@ -1,93 +1,229 @@
 #include <algorithm>
-#include <unordered_map>
+#include <array>
+#include <memory_resource>
+#include <optional>
+#include <span>
 
+#include "columns.h"
 #include "common.h"
+#include "external_sort.h"
+#include "flat_counter.h"
 #include "io.h"
+#include "solution.h"
+#include "sort.h"
+
+namespace
+{
 
 /**
- * Parse line of text into the two integers.
+ * Get the left and right lists of numbers, replacing the contents of `lists`.
  */
-std::pair<int, int> parse_line(const std::string& line)
+void get_lists(std::string_view text, std::array<std::pmr::vector<int>, 2>& lists)
 {
-    // NOTE: rely on fact that integers are separated by three spaces
-    const auto parts = aoc::split(line, "   ");
-    assert(parts.size() == 2);
-    return std::make_pair(std::stoi(parts[0]), std::stoi(parts[1]));
+    aoc::parse_columns(text, lists);
 }
 
 /**
- * Get the left and right lists of numbers.
+ * Total distance between two sorted lists.
  */
-std::pair<std::vector<int>, std::vector<int>> get_lists(const char* filename)
+long long total_distance(std::span<const int> left_list, std::span<const int> right_list)
 {
-    const auto lines = aoc::read_lines(filename);
-
-    std::vector<int> left_list(lines.size());
-    std::vector<int> right_list(lines.size());
-
-    for (int i = 0; i < lines.size(); ++i) {
-        const auto [a, b] = parse_line(lines[i]);
-        left_list[i] = a;
-        right_list[i] = b;
+    long long distance = 0;
+    for (int i = 0; i < left_list.size(); ++i) {
+        distance += std::abs(static_cast<long long>(left_list[i]) - right_list[i]);
     }
+    return distance;
+}
 
-    return std::make_pair(std::move(left_list), std::move(right_list));
+/**
+ * Similarity of two sorted lists, by merge-joining their runs of equal
+ * numbers.
+ */
+long long sorted_similarity(std::span<const int> left_list, std::span<const int> right_list)
+{
+    long long similarity = 0;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < left_list.size() && j < right_list.size()) {
+        if (left_list[i] < right_list[j]) {
+            ++i;
+        } else if (right_list[j] < left_list[i]) {
+            ++j;
+        } else {
+            const int n = left_list[i];
+            long long left_count = 0;
+            long long right_count = 0;
+            for (; i < left_list.size() && left_list[i] == n; ++i) {
+                ++left_count;
+            }
+            for (; j < right_list.size() && right_list[j] == n; ++j) {
+                ++right_count;
+            }
+            similarity += n * left_count * right_count;
+        }
+    }
+    return similarity;
 }
 
-void part1(const std::vector<int>& orig_left_list, const std::vector<int>& orig_right_list)
+/**
+ * Similarity of two lists. Sorted lists are merge-joined, and otherwise the
+ * occurrences in `right_list` are counted.
+ */
+long long similarity(std::span<const int> left_list, std::span<const int> right_list)
 {
-    std::vector<int> left_list = orig_left_list;
-    std::vector<int> right_list = orig_right_list;
+    if (std::is_sorted(left_list.begin(), left_list.end()) && std::is_sorted(right_list.begin(), right_list.end())) {
+        return sorted_similarity(left_list, right_list);
+    }
 
-    // sort
+    // count all occurrences in `right_list`
 
-    std::sort(left_list.begin(), left_list.end());
-    std::sort(right_list.begin(), right_list.end());
+    const auto occurrences = aoc::FlatCounter::count(right_list);
 
-    // compute total distance
+    // compute total similarity
 
-    int distance = 0;
-    for (int i = 0; i < left_list.size(); ++i) {
-        distance += std::abs(left_list[i] - right_list[i]);
+    long long similarity = 0;
+    for (auto n : left_list) {
+        similarity += static_cast<long long>(n) * occurrences[n];
     }
-
-    printf("Day 1 Part 1: %d\n", distance);
+    return similarity;
 }
 
-void part2(const std::vector<int>& left_list, const std::vector<int>& right_list)
+/**
+ * Lists read as a stream, a block at a time, with memory bounded by the
+ * memory budget rather than by the size of the input.
+ *
+ * Part 1 needs both lists sorted, so they go through external sorters, which
+ * spill sorted runs to disk once the budget is used up. Part 2 only needs the
+ * number of occurrences of each number in each list, which is kept as a
+ * histogram as the blocks arrive.
+ */
+class StreamedLists
 {
-    // count all occurrences in `right_list`
+public:
+    StreamedLists() : left_sorter(aoc::memory_budget() / 2), right_sorter(aoc::memory_budget() / 2) {}
+
+    void add(std::span<const int> left_list, std::span<const int> right_list)
+    {
+        assert(left_list.size() == right_list.size());
+        for (const int n : left_list) {
+            left_sorter.push(n);
+            left_counts.add(n);
+        }
+        for (const int n : right_list) {
+            right_sorter.push(n);
+            right_counts.add(n);
+        }
+    }
 
-    std::unordered_map<int, int> occurrences;
-    for (auto n : right_list) {
-        if (occurrences.contains(n)) {
-            ++occurrences[n];
-        } else {
-            occurrences[n] = 1;
+    /**
+     * Total distance between the sorted lists, by merging the sorted runs of
+     * both lists in step. Can only be called once.
+     */
+    long long total_distance()
+    {
+        auto left_reader = left_sorter.sorted();
+        auto right_reader = right_sorter.sorted();
+        long long distance = 0;
+        int left;
+        int right;
+        while (left_reader.next(left)) {
+            const bool has_right = right_reader.next(right);
+            assert(has_right);
+            distance += std::abs(static_cast<long long>(left) - right);
         }
+        return distance;
     }
 
-    // compute total similarity
+    long long similarity() const
+    {
+        long long similarity = 0;
+        left_counts.for_each([&](int n, uint32_t left_count) {
+            similarity += static_cast<long long>(n) * left_count * right_counts[n];
+        });
+        return similarity;
+    }
 
-    int similarity = 0;
-    for (auto n : left_list) {
-        if (occurrences.contains(n)) {
-            similarity += n * occurrences[n];
+private:
+    aoc::ExternalSorter left_sorter;
+    aoc::ExternalSorter right_sorter;
+    aoc::FlatCounter left_counts;
+    aoc::FlatCounter right_counts;
+};
+
+class Day1 : public aoc::Solution
+{
+public:
+    explicit Day1(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : aoc::Solution(resource), lists{std::pmr::vector<int>(resource), std::pmr::vector<int>(resource)}
+    {
+    }
+
+    void parse(std::string_view input) override
+    {
+        streamed.reset();
+        streamed_answers.reset();
+        get_lists(input, lists);
+    }
+
+    /**
+     * Streams (see `aoc::is_stream`) are read a block of lines at a time into
+     * `StreamedLists`, so that the input is never held in memory.
+     */
+    void parse_file(const char* filename) override
+    {
+        if (!aoc::is_stream(filename)) {
+            aoc::Solution::parse_file(filename);
+            return;
         }
+
+        streamed.emplace();
+        streamed_answers.reset();
+        aoc::read_line_blocks(filename, [&](std::string_view block) {
+            get_lists(block, lists);
+            streamed->add(lists[0], lists[1]);
+        });
     }
 
-    printf("Day 1 Part 2: %d\n", similarity);
-}
+    /**
+     * Sort both lists, which part 1 needs and part 2 can merge-join. Streamed
+     * lists are merged from their sorted runs instead.
+     */
+    void prepare() override
+    {
+        if (streamed) {
+            streamed_answers = aoc::Answers{streamed->total_distance(), streamed->similarity()};
+            streamed.reset();
+            return;
+        }
+        aoc::sort_ints(lists[0]);
+        aoc::sort_ints(lists[1]);
+    }
 
-int main(int argc, char** argv)
-{
-    assert(argc == 2);
-    const char* filename = argv[1];
+    long long part1() const override
+    {
+        return streamed_answers ? streamed_answers->part1 : total_distance(lists[0], lists[1]);
+    }
+
+    long long part2() const override
+    {
+        return streamed_answers ? streamed_answers->part2 : similarity(lists[0], lists[1]);
+    }
+
+private:
+    std::array<std::pmr::vector<int>, 2> lists;  // left and right lists, or the last block of a stream
+    std::optional<StreamedLists> streamed;
+    std::optional<aoc::Answers> streamed_answers;
+};
+
+}  // namespace
 
-    const auto [left_list, right_list] = get_lists(filename);
+AOC_REGISTER(Day1, 1);
 
-    part1(left_list, right_list);
-    part2(left_list, right_list);
+#ifndef AOC_NO_MAIN
 
-    return 0;
+int main(int argc, char** argv)
+{
+    return aoc::run_main<Day1>(1, argc, argv);
 }
+
+#endif
@@ -1,119 +1,201 @@
+#include <memory_resource>
+#include <span>
+
+#include "columns.h"
 #include "common.h"
 #include "io.h"
+#include "parallel.h"
+#include "solution.h"
+
+namespace
+{
 
 /**
- * Get all reports from file.
+ * Get all reports, one per line, replacing the contents of `reports`.
  */
-std::vector<std::vector<int>> get_reports(const char* filename)
+void get_reports(std::string_view text, aoc::Ragged<int>& reports)
 {
-    const auto lines = aoc::read_lines(filename);
-
-    std::vector<std::vector<int>> reports;
-    reports.reserve(lines.size());
-
-    for (const auto& line : lines) {
-        // first split each line by " " character
-        const auto levels_as_strings = aoc::split(line, " ");
-
-        // then convert each level into integer
-        reports.emplace_back(aoc::stoi(levels_as_strings));
-    }
-
-    return reports;
+    aoc::parse_rows(text, reports);
 }
 
 /**
- * Copy a report with ith level removed.
+ * Whether a report is safe, and whether it is safe after removing at most
+ * one level.
+ */
+struct Safety {
+    bool safe = false;
+    bool safe_with_removal = false;
+};
+
+/**
+ * Returns whether going from level `a` to level `b` is a step of 1, 2, or 3
+ * in the direction of `sign`.
  */
-std::vector<int> copy_exclude_ith(const std::vector<int>& report, int i)
+bool is_step(int a, int b, int sign)
 {
-    std::vector<int> new_report = report;
-    new_report.erase(new_report.begin() + i);
-    return new_report;
+    const int difference = (b - a) * sign;
+    return difference >= 1 && difference <= 3;
 }
 
 /**
- * Returns whether a report is safe.
+ * Which levels may have been removed from the levels seen so far, for
+ * reports whose levels all step in a single direction.
+ */
+struct SkipState {
+    int sign;
+    bool none = true;     // no level removed
+    bool earlier = true;  // a level before the current one removed
+    bool current = true;  // the current level removed
+
+    /**
+     * Move to the next level.
+     * @param step Whether the previous level steps to the next one
+     * @param jump Whether the level before the previous one steps to the
+     * next one
+     */
+    void advance(bool step, bool jump)
+    {
+        earlier = (earlier & step) | (current & jump);
+        current = none;
+        none = none & step;
+    }
+};
+
+/**
+ * Check whether a report is safe in a single pass, without copying it.
+ *
+ * For both directions, tracks whether the levels so far are valid with no
+ * level removed, with an earlier level removed, or with the current level
+ * removed. A removal can only ever be needed to jump over the current level,
+ * so these three states cover every choice of the level to remove.
  * @param report Report, containing list of levels
- * @param can_tolerate If true, can remove a single level from the report
  */
-bool is_safe(const std::vector<int>& report, bool can_tolerate = false)
+Safety check_report(std::span<const int> report)
 {
-    // first, compute all comparisons and differences
-    std::vector<std::strong_ordering> comparisons(report.size() - 1, std::strong_ordering::equal);
-    std::vector<int> differences(report.size() - 1);
-    for (int i = 0; i <= report.size() - 2; ++i) {
-        comparisons[i] = report[i] <=> report[i + 1];
-        differences[i] = abs(report[i] - report[i + 1]);
+    const std::size_t n = report.size();
+    if (n <= 2) {
+        return {n < 2 || is_step(report[0], report[1], 1) || is_step(report[0], report[1], -1), true};
     }
 
-    // check that all differences are 1, 2, or 3
-    for (int i = 0; i < differences.size(); ++i) {
-        if (differences[i] == 0 || differences[i] > 3) {
-            // there is an issue...
-            if (can_tolerate) {
-                // we can try removing level i or i+1...
-                return is_safe(copy_exclude_ith(report, i)) || is_safe(copy_exclude_ith(report, i + 1));
-            } else {
-                return false;
-            }
-        }
-    }
+    // after the second level: removing either of the first two levels is
+    // valid, and keeping both is valid if they step in the right direction
+    SkipState increasing{1};
+    SkipState decreasing{-1};
+    increasing.none = is_step(report[0], report[1], 1);
+    decreasing.none = is_step(report[0], report[1], -1);
 
-    // check that all comparisons are equal to the previous one
-    for (int i = 1; i < differences.size(); ++i) {
-        if (comparisons[i] != comparisons[i - 1]) {
-            // there is an issue...
-            if (can_tolerate) {
-                // we can try removing level i-1, i, or i+1...
-                return is_safe(copy_exclude_ith(report, i - 1)) || is_safe(copy_exclude_ith(report, i)) ||
-                       is_safe(copy_exclude_ith(report, i + 1));
-            } else {
-                return false;
-            }
-        }
+    for (std::size_t i = 2; i < n; ++i) {
+        increasing.advance(is_step(report[i - 1], report[i], 1), is_step(report[i - 2], report[i], 1));
+        decreasing.advance(is_step(report[i - 1], report[i], -1), is_step(report[i - 2], report[i], -1));
     }
 
-    return true;
+    Safety safety;
+    safety.safe = increasing.none || decreasing.none;
+    safety.safe_with_removal = safety.safe || increasing.earlier || increasing.current || decreasing.earlier ||
+                               decreasing.current;
+    return safety;
 }
 
 /**
- * Count the number of safe reports.
- * @param reports List of reports
- * @param can_tolerate If true, can remove a single level from a report
+ * Number of safe reports, without and with removing a level.
  */
-int count_safe(const std::vector<std::vector<int>>& reports, bool can_tolerate)
-{
-    int num_safe = 0;
-    for (const auto& report : reports) {
-        if (is_safe(report, can_tolerate)) {
-            ++num_safe;
-        }
+struct SafeCounts {
+    long long safe = 0;
+    long long safe_with_removal = 0;
+
+    SafeCounts& operator+=(const SafeCounts& other)
+    {
+        safe += other.safe;
+        safe_with_removal += other.safe_with_removal;
+        return *this;
     }
-    return num_safe;
-}
+};
 
-void part1(const std::vector<std::vector<int>>& reports)
+/**
+ * Count the number of safe reports, checking every report in the buffer once
+ * for both parts. Chunks of reports are checked in parallel.
+ * @param reports List of reports
+ */
+SafeCounts count_safe(const aoc::Ragged<int>& reports)
 {
-    const int num_safe = count_safe(reports, false);
-    printf("Day 2 Part 1: %d\n", num_safe);
+    const std::size_t grain = 1 << 14;
+    return aoc::parallel_reduce(
+        reports.size(), grain, SafeCounts{},
+        [&](std::size_t begin, std::size_t end) {
+            SafeCounts counts;
+            for (std::size_t i = begin; i < end; ++i) {
+                const Safety safety = check_report(reports[i]);
+                counts.safe += safety.safe;
+                counts.safe_with_removal += safety.safe_with_removal;
+            }
+            return counts;
+        },
+        [](SafeCounts a, SafeCounts b) { return a += b; });
 }
 
-void part2(const std::vector<std::vector<int>>& reports)
+class Day2 : public aoc::Solution
 {
-    const int num_safe = count_safe(reports, true);
-    printf("Day 2 Part 2: %d\n", num_safe);
-}
+public:
+    explicit Day2(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : aoc::Solution(resource), reports(resource)
+    {
+    }
 
-int main(int argc, char** argv)
-{
-    assert(argc == 2);
-    const char* filename = argv[1];
+    void parse(std::string_view input) override
+    {
+        streamed = false;
+        get_reports(input, reports);
+    }
 
-    const auto reports = get_reports(filename);
+    /**
+     * Streams (see `aoc::is_stream`) are read a block of lines at a time, and
+     * the reports of each block are checked as soon as it is read, so only one
+     * block of reports is ever in memory.
+     */
+    void parse_file(const char* filename) override
+    {
+        if (!aoc::is_stream(filename)) {
+            aoc::Solution::parse_file(filename);
+            return;
+        }
 
-    part1(reports);
-    part2(reports);
+        streamed = true;
+        counts = SafeCounts{};
+        aoc::read_line_blocks(filename, [&](std::string_view block) {
+            get_reports(block, reports);
+            counts += count_safe(reports);
+        });
+    }
 
-    return 0;
+    /**
+     * Check every report once, for both parts. Streamed reports have already
+     * been checked.
+     */
+    void prepare() override
+    {
+        if (!streamed) {
+            counts = count_safe(reports);
+        }
+    }
+
+    long long part1() const override { return counts.safe; }
+    long long part2() const override { return counts.safe_with_removal; }
+
+private:
+    aoc::Ragged<int> reports;  // all reports, or the last block of a stream
+    bool streamed = false;
+    SafeCounts counts;
+};
+
+}  // namespace
+
+AOC_REGISTER(Day2, 2);
+
+#ifndef AOC_NO_MAIN
+
+int main(int argc, char** argv)
+{
+    return aoc::run_main<Day2>(2, argc, argv);
 }
+
+#endif
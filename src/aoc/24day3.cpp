@@ -1,106 +1,385 @@
-#include <regex>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include "common.h"
 #include "io.h"
+#include "literal.h"
+#include "parallel.h"
+#include "solution.h"
+
+namespace
+{
 
 /**
- * Given a line of corrupted memory, compute all `mul(x, y)` products and
- * return the sum of products.
+ * Streaming scanner over corrupted memory. Recognizes `mul(x,y)`, `do()` and
+ * `don't()` instructions in a single pass, keeping track of whether `mul`
+ * instructions are enabled as it goes.
+ *
+ * Instructions are matched whole, with matchers specialized for the literals
+ * at compile time (see `aoc::Literal`). A hand-written state machine takes
+ * over where an instruction may straddle the end of a chunk or a newline.
+ *
+ * The memory can be fed in chunks of any size, and instructions may straddle
+ * chunks. Newlines are skipped, as if all lines were concatenated.
+ *
+ * To allow chunks to be scanned independently, the scanner does not assume
+ * whether `mul` instructions are enabled at the start: it tracks the enabled
+ * flag and the enabled sum under both possibilities, and scanners over
+ * consecutive chunks are combined with `append`.
  */
-int sum_mul(const std::string& line)
+class Scanner
 {
-    const std::regex re("mul\\((\\d+),(\\d+)\\)");
-    const std::sregex_iterator begin(line.begin(), line.end(), re);
-    const std::sregex_iterator end;
+public:
+    /**
+     * Scan the next chunk of memory. With `use_literals` false, every
+     * character goes through the state machine, which is the baseline of
+     * bench/day3.
+     */
+    template <bool use_literals = true>
+    void feed(std::string_view chunk)
+    {
+        const char* p = chunk.data();
+        const char* end = chunk.data() + chunk.size();
 
-    int sum = 0;
-    for (std::sregex_iterator it = begin; it != end; ++it) {
-        const auto m = *it;
-        assert(m.size() == 3);
-        // submatches are `mul(x,y)`, `x`, and `y`
+        while (p != end) {
+            if (state == State::start) {
+                // fast path: skip ahead to the next possible instruction
+                while (p != end && *p != 'm' && *p != 'd') {
+                    ++p;
+                }
+                if (p == end) {
+                    break;
+                }
 
-        const auto x_str = m[1].str();
-        assert(x_str.size() <= 3);
-        const int x = std::stoi(x_str);
+                if (use_literals && end - p >= MAX_INSTRUCTION_SIZE) {
+                    if (const char* next = match_instruction(p)) {
+                        p = next;
+                        continue;
+                    }
+                    // `m` and `d` only appear at the start of an instruction,
+                    // so the state machine would restart at the next one. only
+                    // a newline can hide an instruction from the matchers.
+                    if (!std::memchr(p, '\n', MAX_INSTRUCTION_SIZE)) {
+                        ++p;
+                        continue;
+                    }
+                }
+            }
+            step(*p++);
+        }
+    }
 
-        const auto y_str = m[2].str();
-        assert(y_str.size() <= 3);
-        const int y = std::stoi(y_str);
+    /**
+     * Finish an instruction that straddles the end of the chunk, by reading
+     * from `rest`, the memory after the chunk. Instructions that start in
+     * `rest` are left for the scanner of the next chunk.
+     */
+    void finish(std::string_view rest)
+    {
+        for (char c : rest) {
+            if (state == State::start || c == 'm' || c == 'd') {
+                break;
+            }
+            step(c);
+        }
+        state = State::start;
+    }
 
-        sum += x * y;
+    /**
+     * Combine with the scanner of the memory directly after this one, as if
+     * both had been scanned by this scanner.
+     */
+    void append(const Scanner& next)
+    {
+        assert(state == State::start);
+        total_all += next.total_all;
+        for (int start_enabled = 0; start_enabled < 2; ++start_enabled) {
+            total_enabled[start_enabled] += next.total_enabled[enabled[start_enabled]];
+            enabled[start_enabled] = next.enabled[enabled[start_enabled]];
+        }
+        state = next.state;
+        x = next.x;
+        y = next.y;
+        num_digits = next.num_digits;
     }
 
-    return sum;
-}
+    /**
+     * Sum of products of all `mul` instructions seen so far.
+     */
+    long long sum_all() const { return total_all; }
 
-/**
- * Given a line of corrupted memory, split by each time `do()` or `don't()` is
- * encountered. Returns a list of `(bool enabled, string subsequence)` where
- * `enabled` means that the corresponding `subsequence` string has `mul`
- * instructions enabled.
- */
-std::vector<std::pair<bool, std::string>> split_mul_enabled(std::string line)
-{
-    // list containing (enabled, subsequence)
-    std::vector<std::pair<bool, std::string>> ret;
+    /**
+     * Sum of products of the enabled `mul` instructions seen so far.
+     */
+    long long sum_enabled() const { return total_enabled[true]; }  // at beginning, `mul` are enabled
 
-    bool enabled = true;  // at beginning, `mul` are enabled
+private:
+    // each state is named after the part of the instruction matched so far
+    enum class State : uint8_t {
+        start,
+        m,
+        mu,
+        mul,
+        mul_open,  // mul(
+        x,         // mul(x
+        comma,     // mul(x,
+        y,         // mul(x,y
+        d,
+        do_,
+        do_open,  // do(
+        don,
+        don_apos,   // don'
+        dont,       // don't
+        dont_open,  // don't(
+    };
 
-    const std::regex re("do\\(\\)|don't\\(\\)");
-    std::smatch m;
-    while (std::regex_search(line, m, re)) {
-        // prefix corresponds to previous `subsequence`
-        ret.emplace_back(enabled, m.prefix());
+    // length of the longest instruction, `mul(999,999)`
+    static constexpr std::ptrdiff_t MAX_INSTRUCTION_SIZE = 12;
 
-        if (m.str().size() == 4) {  // do()
-            enabled = true;
-        } else {  // don't()
-            enabled = false;
+    State state = State::start;
+    int x = 0;
+    int y = 0;
+    int num_digits = 0;
+
+    // indexed by whether `mul` instructions were enabled at the start
+    bool enabled[2] = {false, true};
+    long long total_enabled[2] = {0, 0};
+    long long total_all = 0;
+
+    static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+    void add_product(int product)
+    {
+        total_all += product;
+        for (int start_enabled = 0; start_enabled < 2; ++start_enabled) {
+            if (enabled[start_enabled]) {
+                total_enabled[start_enabled] += product;
+            }
         }
+    }
+
+    void set_enabled(bool value) { enabled[false] = enabled[true] = value; }
 
-        line = m.suffix().str();
+    /**
+     * Read a number of 1-3 digits at `p`.
+     * @returns Pointer past the number, or nullptr if there is none
+     */
+    static const char* read_number(const char* p, int& n)
+    {
+        if (!is_digit(p[0])) {
+            return nullptr;
+        }
+        n = p[0] - '0';
+        int i = 1;
+        for (; i < 3 && is_digit(p[i]); ++i) {
+            n = n * 10 + (p[i] - '0');
+        }
+        return p + i;
     }
 
-    // remaining part of the line
-    ret.emplace_back(enabled, line);
+    /**
+     * Match a whole instruction at `p`, which must have at least
+     * `MAX_INSTRUCTION_SIZE` characters after it, and execute it.
+     * @returns Pointer past the instruction, or nullptr if there is none
+     */
+    const char* match_instruction(const char* p)
+    {
+        if (aoc::match<"mul(">(p)) {
+            int x;
+            int y;
+            const char* q = read_number(p + 4, x);
+            if (q && *q == ',' && (q = read_number(q + 1, y)) && *q == ')') {
+                add_product(x * y);
+                return q + 1;
+            }
+        } else if (aoc::match<"do()">(p)) {
+            set_enabled(true);
+            return p + 4;
+        } else if (aoc::match<"don't()">(p)) {
+            set_enabled(false);
+            return p + 7;
+        }
+        return nullptr;
+    }
 
-    return ret;
-}
+    /**
+     * Go back to the start state on an unexpected character. Since `m` and
+     * `d` only appear at the start of an instruction, the character can only
+     * begin a new instruction, and we never need to backtrack.
+     */
+    void restart(char c) { state = c == 'm' ? State::m : c == 'd' ? State::d : State::start; }
 
-void part1(const std::string& line)
-{
-    const int sum = sum_mul(line);
-    printf("Day 3 Part 1: %d\n", sum);
-}
+    /**
+     * Read one digit of `x` or `y`, which have 1-3 digits.
+     */
+    void read_digit(int& n, char c)
+    {
+        if (num_digits == 3) {
+            restart(c);
+            return;
+        }
+        n = n * 10 + (c - '0');
+        ++num_digits;
+    }
 
-void part2(const std::string& line)
-{
-    int sum = 0;
-    const auto enabled_subsequence_pairs = split_mul_enabled(line);
-    for (const auto& [enabled, subsequence] : enabled_subsequence_pairs) {
-        if (enabled) {
-            sum += sum_mul(subsequence);
+    void step(char c)
+    {
+        if (c == '\n') {
+            return;
+        }
+
+        switch (state) {
+            case State::start:
+                restart(c);
+                break;
+            case State::m:
+                c == 'u' ? void(state = State::mu) : restart(c);
+                break;
+            case State::mu:
+                c == 'l' ? void(state = State::mul) : restart(c);
+                break;
+            case State::mul:
+                c == '(' ? void(state = State::mul_open) : restart(c);
+                break;
+            case State::mul_open:
+                if (is_digit(c)) {
+                    state = State::x;
+                    x = c - '0';
+                    num_digits = 1;
+                } else {
+                    restart(c);
+                }
+                break;
+            case State::x:
+                if (is_digit(c)) {
+                    read_digit(x, c);
+                } else if (c == ',') {
+                    state = State::comma;
+                } else {
+                    restart(c);
+                }
+                break;
+            case State::comma:
+                if (is_digit(c)) {
+                    state = State::y;
+                    y = c - '0';
+                    num_digits = 1;
+                } else {
+                    restart(c);
+                }
+                break;
+            case State::y:
+                if (is_digit(c)) {
+                    read_digit(y, c);
+                } else if (c == ')') {
+                    add_product(x * y);
+                    state = State::start;
+                } else {
+                    restart(c);
+                }
+                break;
+            case State::d:
+                c == 'o' ? void(state = State::do_) : restart(c);
+                break;
+            case State::do_:
+                c == '(' ? void(state = State::do_open) : c == 'n' ? void(state = State::don) : restart(c);
+                break;
+            case State::do_open:
+                if (c == ')') {
+                    set_enabled(true);
+                    state = State::start;
+                } else {
+                    restart(c);
+                }
+                break;
+            case State::don:
+                c == '\'' ? void(state = State::don_apos) : restart(c);
+                break;
+            case State::don_apos:
+                c == 't' ? void(state = State::dont) : restart(c);
+                break;
+            case State::dont:
+                c == '(' ? void(state = State::dont_open) : restart(c);
+                break;
+            case State::dont_open:
+                if (c == ')') {
+                    set_enabled(false);
+                    state = State::start;
+                } else {
+                    restart(c);
+                }
+                break;
         }
     }
-    printf("Day 3 Part 2: %d\n", sum);
+};
+
+/**
+ * Scan the memory in `num_chunks` chunks in parallel, and combine the results.
+ */
+Scanner scan_parallel(std::string_view memory, int num_chunks)
+{
+    std::vector<Scanner> scanners(num_chunks);
+    aoc::default_pool().run(num_chunks, [&](std::size_t i) {
+        const std::size_t begin = memory.size() * i / num_chunks;
+        const std::size_t end = memory.size() * (i + 1) / num_chunks;
+        scanners[i].feed(memory.substr(begin, end - begin));
+        scanners[i].finish(memory.substr(end));
+    });
+
+    Scanner scanner = scanners[0];
+    for (int i = 1; i < num_chunks; ++i) {
+        scanner.append(scanners[i]);
+    }
+    return scanner;
 }
 
-int main(int argc, char** argv)
+/**
+ * The memory is tokenized and evaluated in a single scan while parsing, which
+ * leaves both sums ready for the parts.
+ */
+class Day3 : public aoc::Solution
 {
-    assert(argc == 2);
-    const char* filename = argv[1];
+public:
+    using aoc::Solution::Solution;
 
-    // concatenate file to a single line
-    std::string line;
+    void parse(std::string_view input) override
     {
-        const auto lines = aoc::read_lines(filename);
-        for (const auto& l : lines) {
-            line += l;
+        // split the memory into one chunk per thread. small inputs are not
+        // worth splitting.
+        const int num_chunks = input.size() < (1 << 20) ? 1 : aoc::num_threads();
+        scanner = scan_parallel(input, num_chunks);
+    }
+
+    void parse_file(const char* filename) override
+    {
+        if (aoc::is_stream(filename)) {
+            // stream stdin or a pipe through the scanner, so it is never held
+            // in memory
+            scanner = Scanner();
+            aoc::read_blocks(filename, [&](std::string_view block) { scanner.feed(block); });
+        } else {
+            aoc::Solution::parse_file(filename);
         }
     }
 
-    part1(line);
-    part2(line);
+    long long part1() const override { return scanner.sum_all(); }
+    long long part2() const override { return scanner.sum_enabled(); }
+
+private:
+    Scanner scanner;
+};
 
-    return 0;
+}  // namespace
+
+AOC_REGISTER(Day3, 3);
+
+#ifndef AOC_NO_MAIN
+
+int main(int argc, char** argv)
+{
+    return aoc::run_main<Day3>(3, argc, argv);
 }
+
+#endif
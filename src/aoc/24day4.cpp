@@ -1,38 +1,52 @@
 #include <array>
+#include <cstring>
+#include <memory_resource>
+#include <string>
 
+#include "bitplanes.h"
 #include "common.h"
+#include "grid.h"
+#include "grid_search.h"
 #include "io.h"
+#include "literal.h"
+#include "simd.h"
+#include "solution.h"
+
+namespace
+{
 
 /**
- * Data structure holding the word search puzzle.
+ * Data structure holding the word search puzzle. The grid is padded so that
+ * looking up to 3 cells away from any cell, i.e. the length of "XMAS" minus
+ * one, never goes out of bounds.
  */
 struct Puzzle {
-    std::vector<std::vector<char>> puzzle;
-    int nrows;
-    int ncols;
+    static constexpr int PADDING = 3;
 
-    Puzzle(const char* filename)
-    {
-        const auto lines = aoc::read_lines(filename);
+    aoc::Grid<char> grid;
 
-        nrows = lines.size();
-        puzzle.reserve(nrows);
-        assert(nrows > 0);
-        ncols = lines[0].size();
+    explicit Puzzle(std::string_view text) : grid(aoc::read_grid(text, PADDING)) {}
+    explicit Puzzle(const char* filename) : Puzzle(aoc::Input(filename).view()) {}
 
-        for (int i = 0; i < nrows; ++i) {
-            const auto& line = lines[i];
-            assert(line.size() == ncols);
-            puzzle.emplace_back(line.begin(), line.end());
-        }
-    }
+    /**
+     * Empty puzzle, whose grid is allocated from `resource` when read.
+     */
+    explicit Puzzle(std::pmr::memory_resource* resource) : grid(resource) {}
+
+    /**
+     * Replace the puzzle with the one in `text`, reusing the grid's memory.
+     */
+    void read(std::string_view text) { aoc::read_grid(text, grid, PADDING); }
+
+    int nrows() const { return grid.nrows(); }
+    int ncols() const { return grid.ncols(); }
 
-    char at(int x, int y) const { return puzzle[y][x]; }
+    char at(int x, int y) const { return grid.at(x, y); }
 
     void print() const
     {
-        for (int y = 0; y < nrows; ++y) {
-            for (int x = 0; x < ncols; ++x) {
+        for (int y = 0; y < nrows(); ++y) {
+            for (int x = 0; x < ncols(); ++x) {
                 printf("%c", at(x, y));
             }
             printf("\n");
@@ -40,149 +54,430 @@ struct Puzzle {
     }
 };
 
-void part1(const Puzzle& puzzle)
+// ----------------------------------------------------------------------------
+
+constexpr aoc::Literal KEYWORD = "XMAS";
+constexpr std::array<std::array<int, 2>, 8> DIRECTIONS = {{
+    {1, 0},
+    {1, 1},
+    {0, 1},
+    {-1, 1},
+    {-1, 0},
+    {-1, -1},
+    {0, -1},
+    {1, -1},
+}};
+
+/**
+ * Offset in the grid buffer of one step in each direction.
+ */
+std::array<std::ptrdiff_t, 8> direction_steps(const Puzzle& puzzle)
 {
-    // we just do brute force: we iterate over all starting positions (x, y)
-    // and try to find "XMAS" in all 8 directions.
-
-    static const std::array<char, 4> KEYWORD = {{'X', 'M', 'A', 'S'}};
-    static const std::array<std::array<int, 2>, 8> DIRECTIONS = {{
-        {1, 0},
-        {1, 1},
-        {0, 1},
-        {-1, 1},
-        {-1, 0},
-        {-1, -1},
-        {0, -1},
-        {1, -1},
-    }};
+    std::array<std::ptrdiff_t, 8> steps;
+    for (int i = 0; i < steps.size(); ++i) {
+        steps[i] = DIRECTIONS[i][0] + DIRECTIONS[i][1] * puzzle.grid.stride();
+    }
+    return steps;
+}
 
-    /**
-     * Returns true if we can find "XMAS" starting at (x, y) going in direction (dx, dy).
-     */
-    auto search = [&](int x, int y, int dx, int dy) -> bool {
-        for (auto c : KEYWORD) {
-            if (x < 0 || x >= puzzle.ncols || y < 0 || y >= puzzle.nrows) {
-                return false;
-            }
-            if (puzzle.at(x, y) != c) {
-                return false;
+/**
+ * Returns true if we can find "XMAS" starting at `p` taking steps of size `step`.
+ */
+bool search_xmas(const char* p, std::ptrdiff_t step)
+{
+    // NOTE: the grid is padded by 3 cells, so we can never go out of bounds
+    return aoc::match<KEYWORD>(p, step);
+}
+
+/**
+ * Count "XMAS" starting at cells `x_begin <= x < x_end` of row `y`, one cell
+ * at a time.
+ */
+int count_xmas_cells(const Puzzle& puzzle, int y, int x_begin, int x_end, const std::array<std::ptrdiff_t, 8>& steps)
+{
+    const char* row = puzzle.grid.ptr(0, y);
+    int count = 0;
+    for (int x = x_begin; x < x_end; ++x) {
+        for (auto step : steps) {
+            if (search_xmas(row + x, step)) {
+                ++count;
             }
-            x += dx;
-            y += dy;
         }
-        return true;
-    };
+    }
+    return count;
+}
 
+/**
+ * Count "XMAS" starting in row `y`, `V::WIDTH` cells at a time. For each
+ * direction, the row is compared with the k-th letter of "XMAS" after being
+ * shifted k steps in that direction, which gives a bitmask of the cells where
+ * the keyword starts.
+ */
+template <typename V>
+int count_xmas_row(const Puzzle& puzzle, int y, const std::array<std::ptrdiff_t, 8>& steps)
+{
+    const char* row = puzzle.grid.ptr(0, y);
     int count = 0;
-
-    // do breadth-first search
-    for (int x = 0; x < puzzle.ncols; ++x) {
-        for (int y = 0; y < puzzle.nrows; ++y) {
-            for (const auto& dir : DIRECTIONS) {
-                if (search(x, y, dir[0], dir[1])) {
-                    ++count;
+    int x = 0;
+    for (; x + V::WIDTH <= puzzle.ncols(); x += V::WIDTH) {
+        const char* p = row + x;
+        const auto first = V::eq(V::load(p), V::splat(KEYWORD[0]));
+        if (V::mask(first) == 0) {
+            continue;
+        }
+        for (auto step : steps) {
+            auto match = first;
+            aoc::unroll<KEYWORD>([&](auto k) {
+                if constexpr (k > 0) {
+                    match = V::bit_and(match, V::eq(V::load(p + k * step), V::splat(KEYWORD[k])));
                 }
-            }
+            });
+            count += __builtin_popcount(V::mask(match));
         }
     }
 
-    printf("Day 4 Part 1: %d\n", count);
+    // the loads of the last partial block would run past the padding
+    return count + count_xmas_cells(puzzle, y, x, puzzle.ncols(), steps);
+}
+
+template <typename V>
+int count_xmas_simd(const Puzzle& puzzle)
+{
+    const auto steps = direction_steps(puzzle);
+    int count = 0;
+    for (int y = 0; y < puzzle.nrows(); ++y) {
+        count += count_xmas_row<V>(puzzle, y, steps);
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"), flatten)) int count_xmas_sse42(const Puzzle& puzzle)
+{
+    return count_xmas_simd<aoc::simd::Sse42Bytes>(puzzle);
 }
 
-void part2(const Puzzle& puzzle)
+__attribute__((target("avx2"), flatten)) int count_xmas_avx2(const Puzzle& puzzle)
 {
-    // we iterate over all possible positions of the center "A". if we look at
-    // the four corners of the "X-MAS" in clockwise order, we should see a
-    // permutation of "MMSS".
+    return count_xmas_simd<aoc::simd::Avx2Bytes>(puzzle);
+}
 
-    static const std::array<std::array<int, 2>, 4> DIRECTIONS = {{
-        {1, 1},
-        {-1, 1},
-        {-1, -1},
-        {1, -1},
-    }};
+#endif
 
-    /**
-     * Returns true if (x, y) is the center of an "X-MAS".
-     */
-    auto search = [&](int x, int y) -> bool {
-        if (x <= 0 || x >= puzzle.ncols - 1 || y <= 0 || y >= puzzle.nrows - 1) {
-            return false;
-        }
-        if (puzzle.at(x, y) != 'A') {
-            return false;
+/**
+ * Count the number of times "XMAS" appears, in any direction.
+ */
+int count_xmas(const Puzzle& puzzle, aoc::simd::Level level = aoc::simd::best_level())
+{
+    switch (level) {
+#if defined(__x86_64__)
+        case aoc::simd::Level::avx2:
+            return count_xmas_avx2(puzzle);
+        case aoc::simd::Level::sse42:
+            return count_xmas_sse42(puzzle);
+#endif
+        default:
+            break;
+    }
+
+    // we just do brute force: we iterate over all starting positions (x, y)
+    // and try to find "XMAS" in all 8 directions. we go row by row, so that
+    // the grid is read in memory order.
+
+    const auto steps = direction_steps(puzzle);
+    int count = 0;
+    for (int y = 0; y < puzzle.nrows(); ++y) {
+        count += count_xmas_cells(puzzle, y, 0, puzzle.ncols(), steps);
+    }
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+
+// we look at the four corners of an "X-MAS" in clockwise order
+constexpr std::array<std::array<int, 2>, 4> CORNERS = {{
+    {1, 1},
+    {-1, 1},
+    {-1, -1},
+    {1, -1},
+}};
+
+/**
+ * Offset in the grid buffer of each corner.
+ */
+std::array<std::ptrdiff_t, 4> corner_offsets(const Puzzle& puzzle)
+{
+    std::array<std::ptrdiff_t, 4> offsets;
+    for (int i = 0; i < offsets.size(); ++i) {
+        offsets[i] = CORNERS[i][0] + CORNERS[i][1] * puzzle.grid.stride();
+    }
+    return offsets;
+}
+
+/**
+ * Returns true if `p` is the center of an "X-MAS".
+ */
+bool search_x_mas(const char* p, const std::array<std::ptrdiff_t, 4>& offsets)
+{
+    if (*p != 'A') {
+        return false;
+    }
+
+    std::array<char, 4> corners;
+    for (int i = 0; i < corners.size(); ++i) {
+        corners[i] = p[offsets[i]];
+    }
+
+    // need two "M" and two "S"
+    {
+        int num_m = 0;
+        int num_s = 0;
+        for (char c : corners) {
+            if (c == 'M') {
+                ++num_m;
+            } else if (c == 'S') {
+                ++num_s;
+            }
         }
 
-        std::vector<char> corners(4);
-        for (int i = 0; i < corners.size(); ++i) {
-            const auto& dir = DIRECTIONS[i];
-            corners[i] = puzzle.at(x + dir[0], y + dir[1]);
+        if (num_m != 2 || num_s != 2) {
+            return false;
         }
+    }
 
-        // need two "M" and two "S"
-        {
-            int num_m = 0;
-            int num_s = 0;
-            for (char c : corners) {
-                if (c == 'M') {
-                    ++num_m;
-                } else if (c == 'S') {
-                    ++num_s;
-                }
+    // we count the number of "M -> S" or "S -> M" switches in `corners`.
+    // if it is a permutation of "MMSS", we should only have 2 switches.
+    // otherwise, e.g. for "MSMS", there will be 4 switches.
+    {
+        int num_switches = 0;
+        char prev = corners[3];
+        for (char c : corners) {
+            if (c != prev) {
+                ++num_switches;
             }
+            prev = c;
+        }
 
-            if (num_m != 2 || num_s != 2) {
-                return false;
-            }
+        assert(num_switches == 2 || num_switches == 4);
+        if (num_switches == 4) {
+            return false;
         }
+    }
 
-        // we count the number of "M -> S" or "S -> M" switches in `corners`.
-        // if it is a permutation of "MMSS", we should only have 2 switches.
-        // otherwise, e.g. for "MSMS", there will be 4 switches.
-        {
-            int num_switches = 0;
-            char prev = corners[3];
-            for (char c : corners) {
-                if (c != prev) {
-                    ++num_switches;
-                }
-                prev = c;
-            }
+    return true;
+}
 
-            assert(num_switches == 2 || num_switches == 4);
-            if (num_switches == 4) {
-                return false;
-            }
+/**
+ * Count the centers of an "X-MAS" at cells `x_begin <= x < x_end` of row `y`,
+ * one cell at a time.
+ */
+int count_x_mas_cells(const Puzzle& puzzle, int y, int x_begin, int x_end, const std::array<std::ptrdiff_t, 4>& offsets)
+{
+    const char* row = puzzle.grid.ptr(0, y);
+    int count = 0;
+    for (int x = x_begin; x < x_end; ++x) {
+        if (search_x_mas(row + x, offsets)) {
+            ++count;
         }
+    }
+    return count;
+}
 
-        return true;
+/**
+ * Count the centers of an "X-MAS" in row `y`, `V::WIDTH` cells at a time. The
+ * corners are a permutation of "MMSS" without alternating iff both diagonals
+ * read "MAS" or "SAM", i.e. opposite corners are one "M" and one "S".
+ */
+template <typename V>
+int count_x_mas_row(const Puzzle& puzzle, int y, const std::array<std::ptrdiff_t, 4>& offsets)
+{
+    const auto m = V::splat('M');
+    const auto s = V::splat('S');
+
+    // whether the opposite corners `a` and `b` are one "M" and one "S"
+    auto diagonal = [&](const auto& a, const auto& b) {
+        return V::bit_or(V::bit_and(V::eq(a, m), V::eq(b, s)), V::bit_and(V::eq(a, s), V::eq(b, m)));
     };
 
+    const char* row = puzzle.grid.ptr(0, y);
     int count = 0;
+    int x = 1;
+    for (; x + V::WIDTH <= puzzle.ncols() - 1; x += V::WIDTH) {
+        const char* p = row + x;
+        const auto center = V::eq(V::load(p), V::splat('A'));
+        const auto diagonal1 = diagonal(V::load(p + offsets[0]), V::load(p + offsets[2]));
+        const auto diagonal2 = diagonal(V::load(p + offsets[1]), V::load(p + offsets[3]));
+        count += __builtin_popcount(V::mask(V::bit_and(center, V::bit_and(diagonal1, diagonal2))));
+    }
 
-    // do breadth-first search
-    for (int x = 1; x < puzzle.ncols - 1; ++x) {
-        for (int y = 1; y < puzzle.nrows - 1; ++y) {
-            if (search(x, y)) {
-                ++count;
-            }
-        }
+    return count + count_x_mas_cells(puzzle, y, x, puzzle.ncols() - 1, offsets);
+}
+
+template <typename V>
+int count_x_mas_simd(const Puzzle& puzzle)
+{
+    const auto offsets = corner_offsets(puzzle);
+    int count = 0;
+    for (int y = 1; y < puzzle.nrows() - 1; ++y) {
+        count += count_x_mas_row<V>(puzzle, y, offsets);
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"), flatten)) int count_x_mas_sse42(const Puzzle& puzzle)
+{
+    return count_x_mas_simd<aoc::simd::Sse42Bytes>(puzzle);
+}
+
+__attribute__((target("avx2"), flatten)) int count_x_mas_avx2(const Puzzle& puzzle)
+{
+    return count_x_mas_simd<aoc::simd::Avx2Bytes>(puzzle);
+}
+
+#endif
+
+/**
+ * Count the number of times "MAS" appears twice in the shape of an X.
+ */
+int count_x_mas(const Puzzle& puzzle, aoc::simd::Level level = aoc::simd::best_level())
+{
+    switch (level) {
+#if defined(__x86_64__)
+        case aoc::simd::Level::avx2:
+            return count_x_mas_avx2(puzzle);
+        case aoc::simd::Level::sse42:
+            return count_x_mas_sse42(puzzle);
+#endif
+        default:
+            break;
+    }
+
+    // we iterate over all possible positions of the center "A". cells on the
+    // edge can be skipped, since their corners are outside the grid.
+
+    const auto offsets = corner_offsets(puzzle);
+    int count = 0;
+    for (int y = 1; y < puzzle.nrows() - 1; ++y) {
+        count += count_x_mas_cells(puzzle, y, 1, puzzle.ncols() - 1, offsets);
     }
+    return count;
+}
 
-    printf("Day 4 Part 2: %d\n", count);
+// ----------------------------------------------------------------------------
+
+/**
+ * Count the number of times each word appears, in any direction. This is
+ * linear in the size of the puzzle, no matter how many words there are.
+ */
+std::vector<long long> count_words(const Puzzle& puzzle, const std::vector<std::string>& words)
+{
+    const aoc::AhoCorasick automaton(words);
+    return aoc::count_in_grid(automaton, puzzle.grid);
 }
 
+// ----------------------------------------------------------------------------
+
+/**
+ * How the puzzle is stored. The byte grid supports searching for any words,
+ * while the bitplanes take 4 bits per cell instead of a byte, and the padding,
+ * and only count "XMAS" and "X-MAS".
+ */
+enum class Backend { bytes, bitplanes };
+
+class Day4 : public aoc::Solution
+{
+public:
+    explicit Day4(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                  Backend backend = Backend::bytes)
+        : aoc::Solution(resource), backend(backend), puzzle(resource), planes(resource)
+    {
+    }
+
+    void parse(std::string_view input) override
+    {
+        if (backend == Backend::bytes) {
+            puzzle.read(input);
+        } else {
+            planes.read(input);
+        }
+    }
+
+    long long part1() const override
+    {
+        return backend == Backend::bytes ? count_xmas(puzzle) : aoc::count_word<KEYWORD>(planes);
+    }
+
+    long long part2() const override
+    {
+        return backend == Backend::bytes ? count_x_mas(puzzle) : aoc::count_cross<"MAS">(planes);
+    }
+
+    /**
+     * Count the number of times each of the extra words appears. Needs the
+     * byte grid.
+     */
+    std::vector<long long> count_words(const std::vector<std::string>& words) const
+    {
+        assert(backend == Backend::bytes);
+        return ::count_words(puzzle, words);
+    }
+
+private:
+    Backend backend;
+    Puzzle puzzle;                      // if `backend` is bytes
+    aoc::LetterPlanes<KEYWORD> planes;  // if `backend` is bitplanes
+};
+
+}  // namespace
+
+AOC_REGISTER(Day4, 4);
+
+// ----------------------------------------------------------------------------
+
+#ifndef AOC_NO_MAIN
 
 int main(int argc, char** argv)
 {
-    assert(argc == 2);
+    // optionally, a file of extra words to search for, one per line, or
+    // `--bitplanes` to store the puzzle as bitplanes
+    aoc::RunOptions options;
+    argc = aoc::parse_run_options(argc, argv, options);
+    Backend backend = Backend::bytes;
+    int j = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bitplanes") == 0) {
+            backend = Backend::bitplanes;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    argc = j;
+    assert(argc == 2 || (argc == 3 && backend == Backend::bytes));
     const char* filename = argv[1];
 
-    const Puzzle puzzle(filename);
+    aoc::Arena arena;
+    Day4 solution(arena.resource(), backend);
+    aoc::run_day(4, solution, filename, options);
+
+    if (argc == 3) {
+        const aoc::Input words_input(argv[2]);
+        std::vector<std::string> words;
+        for (const auto line : words_input.lines()) {
+            if (!line.empty()) {
+                words.emplace_back(line);
+            }
+        }
 
-    part1(puzzle);
-    part2(puzzle);
+        const auto counts = solution.count_words(words);
+        for (int i = 0; i < words.size(); ++i) {
+            printf("%s: %lld\n", words[i].c_str(), counts[i]);
+        }
+    }
 
     return 0;
 }
+
+#endif
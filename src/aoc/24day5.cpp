@@ -1,9 +1,23 @@
 #include <algorithm>
-#include <numeric>
-
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bitmatrix.h"
 #include "common.h"
 #include "io.h"
+#include "parallel.h"
+#include "ragged.h"
+#include "simd.h"
+#include "solution.h"
 
+namespace
+{
 
 struct Rule {
     int first;
@@ -12,198 +26,649 @@ struct Rule {
     Rule(int first, int second) : first(first), second(second) {}
 };
 
-using Update = std::vector<int>;
+/**
+ * Pages of an update. All updates are stored in one `aoc::Ragged`, so an
+ * update is a view of its row.
+ */
+using Update = std::span<const int>;
 
 /**
- * Given lines, parse the rules.
+ * Given lines, parse the rules into `rules`.
  * @param begin Iterator to start of vector of lines.
  * @param end Iterator to end of vector of lines.
  */
-std::vector<Rule> parse_rules(
-    std::vector<std::string>::const_iterator begin, std::vector<std::string>::const_iterator end)
+void parse_rules(aoc::Lines::iterator begin, aoc::Lines::iterator end, std::pmr::vector<Rule>& rules)
 {
-    std::vector<Rule> rules;
-    rules.reserve(end - begin);
-
+    std::array<int, 2> pages;
     for (auto it = begin; it != end; ++it) {
-        const auto parts = aoc::split(*it, "|");
-        assert(parts.size() == 2);  // rule must contain two integers
-        rules.emplace_back(std::stoi(parts[0]), std::stoi(parts[1]));
+        const auto num_pages = aoc::parse_ints(*it, '|', pages);
+        assert(num_pages == 2);  // rule must contain two integers
+        rules.emplace_back(pages[0], pages[1]);
     }
-
-    return rules;
 }
 
 /**
- * Given lines, parse the updates.
+ * Given lines, parse the updates into `updates`, one row per update.
  * @param begin Iterator to start of vector of lines.
  * @param end Iterator to end of vector of lines.
  */
-std::vector<Update> parse_updates(
-    std::vector<std::string>::const_iterator begin, std::vector<std::string>::const_iterator end)
+void parse_updates(aoc::Lines::iterator begin, aoc::Lines::iterator end, aoc::Ragged<int>& updates)
 {
-    std::vector<Update> updates;
-    updates.reserve(end - begin);
-
+    std::vector<int> pages;  // sized for each update, which can have any number of pages
     for (auto it = begin; it != end; ++it) {
-        const auto parts = aoc::split(*it, ",");
-        assert(parts.size() % 2 == 1);  // update should have odd number of pages
-        updates.emplace_back(aoc::stoi(parts));
+        pages.resize(std::count(it->begin(), it->end(), ',') + 1);
+        const auto num_pages = aoc::parse_ints(*it, ',', pages);
+        assert(num_pages % 2 == 1);  // update should have odd number of pages
+        updates.push_row(std::span<const int>(pages.data(), num_pages));
     }
-
-    return updates;
 }
 
 /**
- * Get rules and updates from text file.
+ * Get rules and updates from the input text, replacing the contents of
+ * `rules` and `updates`.
  */
-std::pair<std::vector<Rule>, std::vector<Update>> get_rules_and_updates(const char* filename)
+void get_rules_and_updates(std::string_view text, std::pmr::vector<Rule>& rules, aoc::Ragged<int>& updates)
 {
-    const auto lines = aoc::read_lines(filename);
+    const aoc::Lines lines(text);
 
     // find the empty line, which separates the rules from the updates
     const auto split = std::find(lines.begin(), lines.end(), "");
     assert(split != lines.end());
 
-    const auto rules = parse_rules(lines.begin(), split);
-    const auto updates = parse_updates(split + 1, lines.end());
+    // every page takes at least three bytes, including its separator
+    const std::size_t update_bytes = text.data() + text.size() - split->data();
+    rules.clear();
+    updates.clear();
+    updates.reserve(0, update_bytes / 3 + 1);
 
-    return std::make_pair(std::move(rules), std::move(updates));
+    parse_rules(lines.begin(), split, rules);
+    parse_updates(std::next(split), lines.end(), updates);
 }
 
 // ----------------------------------------------------------------------------
 
 /**
- * Check that the update satisfies the given rule.
+ * Precomputed index of the rules, as a bit matrix where bit (a, b) is set iff
+ * page `a` must come before page `b`, and its transpose. Pages are numbered
+ * `0 <= page < num_pages`.
  */
-bool check_rule(const Update& update, const Rule& rule)
+class PrecedenceIndex
 {
-    const auto rule_first_ptr = std::find(update.begin(), update.end(), rule.first);
-    const auto rule_second_ptr = std::find(update.begin(), update.end(), rule.second);
+public:
+    PrecedenceIndex(std::span<const Rule> rules, int num_pages) : matrix(num_pages), transposed(num_pages)
+    {
+        for (const auto& rule : rules) {
+            matrix.set(rule.first, rule.second);
+            transposed.set(rule.second, rule.first);
+        }
+    }
+
+    int num_pages() const { return matrix.size(); }
+
+    /**
+     * Returns true if a rule says page `a` must come before page `b`.
+     */
+    bool before(int a, int b) const { return matrix.test(a, b); }
+
+    /**
+     * Pages that a rule says must come after page `a`, as a row of bits.
+     */
+    std::span<const uint64_t> successors(int a) const { return matrix.row(a); }
+
+    /**
+     * Pages that a rule says must come before page `a`, as a row of bits.
+     */
+    std::span<const uint64_t> predecessors(int a) const { return transposed.row(a); }
+
+    /**
+     * Add the rule that page `a` must come before page `b`.
+     * @returns False if there already was such a rule
+     */
+    bool add(int a, int b)
+    {
+        if (matrix.test(a, b)) {
+            return false;
+        }
+        matrix.set(a, b);
+        transposed.set(b, a);
+        return true;
+    }
 
-    // if either number cannot be found, then return `true` since the rule is vacuously satisfied
-    if (rule_first_ptr == update.end() || rule_second_ptr == update.end()) {
+    /**
+     * Remove the rule that page `a` must come before page `b`.
+     * @returns False if there was no such rule
+     */
+    bool remove(int a, int b)
+    {
+        if (!matrix.test(a, b)) {
+            return false;
+        }
+        matrix.reset(a, b);
+        transposed.reset(b, a);
         return true;
     }
 
-    // check rule is satisfied
-    return rule_first_ptr < rule_second_ptr;
-}
+    /**
+     * Check that the update satisfies all rules, i.e. no page must come
+     * before a page preceding it. Rules about pages not in the update are
+     * vacuously satisfied.
+     */
+    bool check(Update update) const
+    {
+        for (int j = 1; j < update.size(); ++j) {
+            for (int i = 0; i < j; ++i) {
+                if (before(update[j], update[i])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    aoc::BitMatrix matrix;
+    aoc::BitMatrix transposed;
+};
 
 /**
- * Check that the update satisfies all given rules.
+ * Number of pages needed to index all pages in the rules and updates.
  */
-bool check_rules(const Update& update, const std::vector<Rule>& rules)
+int count_pages(std::span<const Rule> rules, const aoc::Ragged<int>& updates)
 {
+    int max_page = 0;
     for (const auto& rule : rules) {
-        if (!check_rule(update, rule)) {
-            return false;
+        max_page = std::max({max_page, rule.first, rule.second});
+    }
+    for (const Update update : updates) {
+        for (int page : update) {
+            max_page = std::max(max_page, page);
         }
     }
-    return true;
+    return max_page + 1;
 }
 
-void part1(const std::vector<Update>& updates, const std::vector<Rule>& rules)
+/**
+ * Number of updates checked per task.
+ */
+constexpr std::size_t UPDATES_GRAIN = 1 << 12;
+
+/**
+ * Check every update against the rules.
+ * @returns For each update, whether it is correctly ordered
+ */
+std::vector<char> check_updates(const aoc::Ragged<int>& updates, const PrecedenceIndex& index)
 {
-    int sum_of_middle = 0;
+    std::vector<char> valid(updates.size());
+    aoc::parallel_for(updates.size(), UPDATES_GRAIN, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            valid[i] = index.check(updates[i]);
+        }
+    });
+    return valid;
+}
 
-    for (const auto& update : updates) {
-        if (check_rules(update, rules)) {
-            const int size = update.size();
-            sum_of_middle += update[(size - 1) / 2];
+/**
+ * Sum of the middle pages of the correctly-ordered updates.
+ */
+long long sum_valid_middles(const aoc::Ragged<int>& updates, const std::vector<char>& valid)
+{
+    long long sum_of_middle = 0;
+    for (int i = 0; i < updates.size(); ++i) {
+        if (valid[i]) {
+            const int size = updates[i].size();
+            sum_of_middle += updates[i][(size - 1) / 2];
         }
     }
-
-    printf("Day 5 Part 1: %d\n", sum_of_middle);
+    return sum_of_middle;
 }
 
 // ----------------------------------------------------------------------------
 
-Update order_update(const Update& update, const std::vector<Rule>& rules)
+/**
+ * Scratch space for `order_update`, so that buffers are reused between
+ * updates instead of being allocated for each one.
+ */
+struct OrderScratch {
+    std::vector<int> num_incoming_edges;
+    std::vector<uint64_t> pages;  // bit set of the pages of an update
+};
+
+/**
+ * Order the pages of an update so that it satisfies all rules.
+ *
+ * The relevant rules form a graph on the pages of the update: the relation
+ * A < B is encoded as a directed edge A -> B. We topologically sort this
+ * graph with Kahn's algorithm, which only needs the rules to be a partial
+ * order. When several pages could come next, the one earliest in the update
+ * is picked, so the result is deterministic. This takes O(k^2) time for an
+ * update of k pages.
+ *
+ * @param ordered_update Output. Filled with the ordered pages.
+ * @returns False if the rules contain a cycle, in which case no order exists.
+ */
+bool order_update(Update update,
+                  const PrecedenceIndex& index,
+                  std::vector<int>& ordered_update,
+                  OrderScratch& scratch)
 {
-    // First, we encode the relevant rules as a graph: the relation A < B is
-    // encoded as a directed edge A -> B. We represent this graph as an
-    // adjacency matrix, where M[A][B] is non-zero iff A -> B is an edge in the
-    // graph.
+    const int size = update.size();
+    ordered_update.clear();
+
+    // count the incoming edges of each page. a page that has been placed is
+    // marked with -1.
+    auto& num_incoming_edges = scratch.num_incoming_edges;
+    num_incoming_edges.assign(size, 0);
+    for (int a = 0; a < size; ++a) {
+        for (int b = 0; b < size; ++b) {
+            num_incoming_edges[b] += index.before(update[a], update[b]);
+        }
+    }
 
-    std::vector<std::vector<bool>> rule_graph;
-    {
-        // initialize
-        rule_graph.reserve(update.size());
-        for (int i = 0; i < update.size(); ++i) {
-            rule_graph.emplace_back(update.size(), false);
+    // repeatedly place a page with no incoming edges, and remove its
+    // outgoing edges
+    for (int n = 0; n < size; ++n) {
+        int a = 0;
+        while (a < size && num_incoming_edges[a] != 0) {
+            ++a;
+        }
+        if (a == size) {
+            return false;  // every remaining page has an incoming edge, so there is a cycle
         }
 
-        // fill in edges
-        for (const auto& rule : rules) {
-            const auto rule_first_ptr = std::find(update.begin(), update.end(), rule.first);
-            const auto rule_second_ptr = std::find(update.begin(), update.end(), rule.second);
-            if (rule_first_ptr != update.end() && rule_second_ptr != update.end()) {
-                const int a = rule_first_ptr - update.begin();
-                const int b = rule_second_ptr - update.begin();
-                rule_graph[a][b] = true;
-            }
+        ordered_update.push_back(update[a]);
+        num_incoming_edges[a] = -1;
+        for (int b = 0; b < size; ++b) {
+            num_incoming_edges[b] -= index.before(update[a], update[b]);
         }
     }
 
-    // Second, we find a path in the graph that connects all nodes. Such a path
-    // will correspond to the ordered update.
+    return true;
+}
 
-    Update ordered_update;
-    {
-        // HACK: if we assume the rules are complete, i.e. our graph is a total
-        // ordering, then we can find such a path by just sorting the nodes by
-        // the number of outgoing edges.
+/**
+ * Order the pages of an update by rank, when the rules order every pair of
+ * its pages, which the puzzle input guarantees.
+ *
+ * A page's rank is its number of successors in the update. It is one popcount
+ * per word of the page's row of the bit matrix, masked with the bit set of the
+ * update's pages, so the whole update takes O(k * num_pages / 64) word
+ * operations and no comparisons. If every pair of pages is ordered by exactly
+ * one rule, and the ranks are distinct, the rules are a total order on the
+ * update (a tournament is transitive iff its scores are 0, 1, ..., k-1), so the
+ * page of rank r goes to position k-1-r, and this is the only valid order.
+ *
+ * Sorting with the bit matrix as the comparator would be undefined when the
+ * rules are not a strict weak order on the update, so anything else, as well
+ * as updates of more than 64 pages, is left to `order_update`.
+ *
+ * @param ordered_update Output. Filled with the ordered pages.
+ * @returns False if the rules are not a total order on the update's pages
+ */
+inline bool rank_update_generic(Update update,
+                                const PrecedenceIndex& index,
+                                std::vector<int>& ordered_update,
+                                OrderScratch& scratch)
+{
+    const int size = update.size();
+    if (size > 64) {
+        return false;
+    }
+    const std::size_t num_words = index.successors(0).size();
 
-        // list of {num_outgoing_edges, number} pairs
-        std::vector<std::pair<int, int>> edge_counts;
+    auto& pages = scratch.pages;
+    pages.assign(num_words, 0);
+    for (const int page : update) {
+        pages[page / 64] |= uint64_t(1) << (page % 64);
+    }
 
-        edge_counts.reserve(update.size());
-        for (int i = 0; i < update.size(); ++i) {
-            const int num_outgoing_edges = std::accumulate(rule_graph[i].begin(), rule_graph[i].end(), 0);
-            edge_counts.emplace_back(num_outgoing_edges, update[i]);
+    uint64_t placed = 0;  // bit i is set once position i is taken
+    ordered_update.resize(size);
+    for (const int page : update) {
+        const uint64_t* successors = index.successors(page).data();
+        const uint64_t* predecessors = index.predecessors(page).data();
+        int num_successors = 0;
+        int num_related = 0;
+        for (std::size_t w = 0; w < num_words; ++w) {
+            const uint64_t after = successors[w] & pages[w];
+            const uint64_t before = predecessors[w] & pages[w];
+            if (after & before) {
+                return false;  // rules both ways, or a page before itself
+            }
+            num_successors += __builtin_popcountll(after);
+            num_related += __builtin_popcountll(after | before);
         }
 
-        // sort by first key in decreasing order, i.e. largest first key at front
-        auto cmp = [](const std::pair<int, int>& x, const std::pair<int, int>& y) -> bool { return x.first > y.first; };
-        std::sort(edge_counts.begin(), edge_counts.end(), cmp);
-
-        // check our HACK assumption was correct
-        for (int i = 0; i < edge_counts.size(); ++i) {
-            assert(edge_counts[i].first == edge_counts.size() - i - 1);
-            ordered_update.emplace_back(edge_counts[i].second);
+        // every other page is related to this one. a repeated page is never
+        // related to itself, so it fails this check too.
+        const int position = size - 1 - num_successors;
+        if (num_related != size - 1 || (placed >> position & 1)) {
+            return false;
         }
+        placed |= uint64_t(1) << position;
+        ordered_update[position] = page;
     }
 
-    return ordered_update;
+    return true;
 }
 
-void part2(const std::vector<Update>& updates, const std::vector<Rule>& rules)
+#if defined(__x86_64__)
+
+// sse4.2 comes with the popcnt instruction, which is otherwise a library call
+__attribute__((target("sse4.2"), flatten)) bool rank_update_sse42(Update update,
+                                                                  const PrecedenceIndex& index,
+                                                                  std::vector<int>& ordered_update,
+                                                                  OrderScratch& scratch)
 {
-    int sum_of_middle = 0;
+    return rank_update_generic(update, index, ordered_update, scratch);
+}
 
-    for (const auto& update : updates) {
-        if (!check_rules(update, rules)) {
-            const auto ordered_update = order_update(update, rules);
-            const int size = ordered_update.size();
-            sum_of_middle += ordered_update[(size - 1) / 2];
-        }
+#endif
+
+bool rank_update(Update update,
+                 const PrecedenceIndex& index,
+                 std::vector<int>& ordered_update,
+                 OrderScratch& scratch,
+                 aoc::simd::Level level = aoc::simd::best_level())
+{
+#if defined(__x86_64__)
+    if (level >= aoc::simd::Level::sse42) {
+        return rank_update_sse42(update, index, ordered_update, scratch);
     }
+#endif
+    return rank_update_generic(update, index, ordered_update, scratch);
+}
 
-    printf("Day 5 Part 2: %d\n", sum_of_middle);
+/**
+ * Order the pages of an update so that it satisfies all rules, by rank when
+ * the rules order every pair of its pages, and otherwise with Kahn's
+ * algorithm. Both give the same order when the rank applies.
+ * @returns False if the rules contain a cycle, in which case no order exists.
+ */
+bool reorder_update(Update update,
+                    const PrecedenceIndex& index,
+                    std::vector<int>& ordered_update,
+                    OrderScratch& scratch)
+{
+    return rank_update(update, index, ordered_update, scratch) || order_update(update, index, ordered_update, scratch);
+}
+
+/**
+ * Result of ordering a range of incorrectly-ordered updates.
+ */
+struct Reordered {
+    long long sum_of_middle = 0;
+    std::vector<int> cycles;  // indices of updates whose pages cannot be ordered
+};
+
+/**
+ * Order the incorrectly-ordered updates, and sum their middle pages. Updates
+ * that cannot be ordered are skipped, and returned in `cycles`.
+ */
+Reordered reorder_updates(const aoc::Ragged<int>& updates, const std::vector<char>& valid, const PrecedenceIndex& index)
+{
+    return aoc::parallel_reduce(
+        updates.size(), UPDATES_GRAIN, Reordered{},
+        [&](std::size_t begin, std::size_t end) {
+            Reordered result;
+            OrderScratch scratch;
+            std::vector<int> ordered_update;
+            for (std::size_t i = begin; i < end; ++i) {
+                if (!valid[i]) {
+                    if (!reorder_update(updates[i], index, ordered_update, scratch)) {
+                        result.cycles.push_back(i);
+                        continue;
+                    }
+                    const int size = ordered_update.size();
+                    result.sum_of_middle += ordered_update[(size - 1) / 2];
+                }
+            }
+            return result;
+        },
+        [](Reordered a, Reordered b) {
+            a.sum_of_middle += b.sum_of_middle;
+            a.cycles.insert(a.cycles.end(), b.cycles.begin(), b.cycles.end());
+            return a;
+        });
 }
 
 // ----------------------------------------------------------------------------
 
-int main(int argc, char** argv)
+/**
+ * Checker for rules and updates that arrive over time, e.g. in a long-lived
+ * service, which keeps the answers to both parts up to date as they do.
+ *
+ * Besides the precedence index, it keeps a reverse index from each page to
+ * the updates that contain it, in the order they were added. A rule about two
+ * pages can only change the outcome of the updates that contain both, which
+ * are found by merging the two sorted lists. Adding or removing a rule checks,
+ * and if needed reorders, just the affected updates, and adjusts the running
+ * totals by the change in their middle pages. This takes O(k^2) time for each
+ * affected update of k pages, plus the merge, instead of a pass over all
+ * updates. The index takes one id per page of each update, so it grows with
+ * the updates and not with the number of pairs of pages.
+ */
+class IncrementalChecker
+{
+public:
+    /**
+     * Checker without rules or updates, for pages `0 <= page < num_pages`.
+     */
+    explicit IncrementalChecker(int num_pages)
+        : index(std::span<const Rule>(), num_pages), updates_of_page(num_pages)
+    {
+    }
+
+    /**
+     * Add a rule, and recheck the updates with both of its pages.
+     * @returns False if the rule was already there, in which case nothing
+     * changes
+     */
+    bool add_rule(Rule rule)
+    {
+        if (!index.add(rule.first, rule.second)) {
+            return false;
+        }
+        recheck(rule);
+        return true;
+    }
+
+    /**
+     * Remove a rule, and recheck the updates with both of its pages.
+     * @returns False if there was no such rule
+     */
+    bool remove_rule(Rule rule)
+    {
+        if (!index.remove(rule.first, rule.second)) {
+            return false;
+        }
+        recheck(rule);
+        return true;
+    }
+
+    /**
+     * Add an update, index its pages, and check it.
+     */
+    void add_update(Update update)
+    {
+        assert(update.size() % 2 == 1);  // update should have odd number of pages
+        const auto id = static_cast<uint32_t>(updates.size());
+        updates.push_row(update);
+        for (const int page : update) {
+            assert(page >= 0 && page < static_cast<int>(updates_of_page.size()));
+            auto& ids = updates_of_page[page];
+            if (ids.empty() || ids.back() != id) {  // a page may repeat
+                ids.push_back(id);
+            }
+        }
+        outcomes.emplace_back();
+        check(id);
+    }
+
+    std::size_t num_updates() const { return updates.size(); }
+
+    /**
+     * Answer to part 1, i.e. the sum of the middle pages of the correctly
+     * ordered updates.
+     */
+    long long sum_valid_middles() const { return valid_total; }
+
+    /**
+     * Answer to part 2, i.e. the sum of the middle pages of the incorrectly
+     * ordered updates, once ordered.
+     */
+    long long sum_reordered_middles() const { return reordered_total; }
+
+    /**
+     * Number of updates whose pages the rules order in a cycle. They count
+     * towards neither answer.
+     */
+    std::size_t num_cycles() const { return cycles; }
+
+    /**
+     * Number of updates checked so far, including when they were added.
+     */
+    std::size_t num_checks() const { return checks; }
+
+private:
+    enum class Status : uint8_t { unchecked, valid, reordered, cycle };
+
+    /**
+     * Outcome of the last check of an update, i.e. what it adds to the totals.
+     */
+    struct Outcome {
+        Status status = Status::unchecked;
+        int middle = 0;
+    };
+
+    PrecedenceIndex index;
+    aoc::Ragged<int> updates;
+    std::vector<Outcome> outcomes;
+    std::vector<std::vector<uint32_t>> updates_of_page;  // ids in ascending order
+
+    long long valid_total = 0;
+    long long reordered_total = 0;
+    std::size_t cycles = 0;
+    std::size_t checks = 0;
+
+    OrderScratch scratch;
+    std::vector<int> ordered_update;
+
+    /**
+     * Check the updates that contain both pages of a rule.
+     */
+    void recheck(Rule rule)
+    {
+        const auto& a = updates_of_page[rule.first];
+        const auto& b = updates_of_page[rule.second];
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                check(a[i]);
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+    /**
+     * Check an update again, and replace its old outcome in the totals with
+     * the new one.
+     */
+    void check(uint32_t id)
+    {
+        Outcome& outcome = outcomes[id];
+        switch (outcome.status) {
+            case Status::valid:
+                valid_total -= outcome.middle;
+                break;
+            case Status::reordered:
+                reordered_total -= outcome.middle;
+                break;
+            case Status::cycle:
+                --cycles;
+                break;
+            case Status::unchecked:
+                break;
+        }
+
+        const Update update = updates[id];
+        const std::size_t middle = (update.size() - 1) / 2;
+        if (index.check(update)) {
+            outcome = {Status::valid, update[middle]};
+            valid_total += outcome.middle;
+        } else if (reorder_update(update, index, ordered_update, scratch)) {
+            outcome = {Status::reordered, ordered_update[middle]};
+            reordered_total += outcome.middle;
+        } else {
+            outcome = {Status::cycle, 0};
+            ++cycles;
+        }
+        ++checks;
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+class Day5 : public aoc::Solution
 {
-    assert(argc == 2);
-    const char* filename = argv[1];
+public:
+    explicit Day5(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : aoc::Solution(resource), rules(resource), updates(resource)
+    {
+    }
 
-    const auto [rules, updates] = get_rules_and_updates(filename);
+    void parse(std::string_view input) override { get_rules_and_updates(input, rules, updates); }
 
-    part1(updates, rules);
-    part2(updates, rules);
+    /**
+     * Index the rules and check every update once, for both parts.
+     */
+    void prepare() override
+    {
+        index.emplace(rules, count_pages(rules, updates));
+        valid = check_updates(updates, *index);
+    }
+
+    long long part1() const override { return sum_valid_middles(updates, valid); }
+    long long part2() const override
+    {
+        Reordered reordered = reorder_updates(updates, valid, *index);
+        cycles = std::move(reordered.cycles);
+        return reordered.sum_of_middle;
+    }
+
+    std::vector<std::string> warnings() const override
+    {
+        std::vector<std::string> messages;
+        for (const int i : cycles) {
+            messages.push_back("rules form a cycle on the pages of update " + std::to_string(i + 1) + ", skipping it");
+        }
+        return messages;
+    }
+
+private:
+    std::pmr::vector<Rule> rules;
+    aoc::Ragged<int> updates;
+    std::optional<PrecedenceIndex> index;
+    std::vector<char> valid;
+    mutable std::vector<int> cycles;  // updates skipped by the last run of part 2
+};
+
+}  // namespace
+
+AOC_REGISTER(Day5, 5);
+
+// ----------------------------------------------------------------------------
 
-    return 0;
+#ifndef AOC_NO_MAIN
+
+int main(int argc, char** argv)
+{
+    return aoc::run_main<Day5>(5, argc, argv);
 }
+
+#endif
@@ -0,0 +1,197 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "arena.h"
+#include "bench.h"
+#include "io.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day1.cpp"
+#include "../aoc/24day2.cpp"
+#include "../aoc/24day3.cpp"
+#include "../aoc/24day4.cpp"
+#include "../aoc/24day5.cpp"
+
+// ----------------------------------------------------------------------------
+
+// every allocation of the process goes through these operators, so they count
+// the allocations of the days, their arenas and the thread pool alike. gcc
+// cannot tell that the pointers freed here come from the `malloc` below.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+std::atomic<std::size_t> num_allocations = 0;
+std::atomic<std::size_t> num_bytes = 0;
+
+void* operator new(std::size_t size)
+{
+    ++num_allocations;
+    num_bytes += size;
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++num_allocations;
+    num_bytes += size;
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Number and total size of the allocations made by `fn`.
+ */
+template <typename Fn>
+std::pair<std::size_t, std::size_t> count_allocations(Fn&& fn)
+{
+    const std::size_t allocations_before = num_allocations;
+    const std::size_t bytes_before = num_bytes;
+    fn();
+    return {num_allocations - allocations_before, num_bytes - bytes_before};
+}
+
+void report(int day, const char* variant, std::pair<std::size_t, std::size_t> counts)
+{
+    printf("%-4d %-24s %12zu %12.2f\n", day, variant, counts.first, counts.second / 1e6);
+}
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Day 2 parsed the way the original solution did, with one string per line,
+ * one string per level and one vector per report.
+ */
+std::vector<std::vector<int>> per_line_reports(const char* filename)
+{
+    std::vector<std::vector<int>> reports;
+    for (const auto& line : aoc::read_lines(filename)) {
+        reports.push_back(aoc::stoi(aoc::split(line, " ")));
+    }
+    return reports;
+}
+
+/**
+ * Day 5 parsed the way the original solution did, with one string per line,
+ * one string per page and one vector per rule and per update.
+ */
+std::pair<std::vector<std::vector<int>>, std::vector<std::vector<int>>> per_line_rules_and_updates(
+    const char* filename)
+{
+    std::vector<std::vector<int>> rules;
+    std::vector<std::vector<int>> updates;
+    bool in_rules = true;
+    for (const auto& line : aoc::read_lines(filename)) {
+        if (line.empty()) {
+            in_rules = false;
+        } else if (in_rules) {
+            rules.push_back(aoc::stoi(aoc::split(line, "|")));
+        } else {
+            updates.push_back(aoc::stoi(aoc::split(line, ",")));
+        }
+    }
+    return {std::move(rules), std::move(updates)};
+}
+
+/**
+ * Run every stage of a solution on an input twice, as the benchmark mode
+ * does, so that the second run shows whether buffers are reused.
+ */
+void run_twice(aoc::Solution& solution, std::string_view input)
+{
+    for (int i = 0; i < 2; ++i) {
+        solution.parse(input);
+        solution.prepare();
+        aoc::bench::do_not_optimize(solution.part1());
+        aoc::bench::do_not_optimize(solution.part2());
+    }
+}
+
+/**
+ * Count the heap allocations made while parsing and solving each day's input,
+ * with the solution's data allocated from the default heap and from an arena.
+ * Days 2 and 5 are also parsed line by line into nested vectors, as the
+ * original solutions did, for comparison.
+ *
+ * Usage: bench/alloc [data_dir]
+ */
+int main(int argc, char** argv)
+{
+    const std::string data_dir = argc > 1 ? argv[1] : "data";
+
+    // start the threads of the pool, so that they are not counted
+    aoc::parallel_for(aoc::num_threads(), 1, [](std::size_t, std::size_t) {});
+
+    using Make = std::unique_ptr<aoc::Solution> (*)(std::pmr::memory_resource*);
+    const std::pair<int, Make> days[] = {
+        {1, [](std::pmr::memory_resource* r) -> std::unique_ptr<aoc::Solution> { return std::make_unique<Day1>(r); }},
+        {2, [](std::pmr::memory_resource* r) -> std::unique_ptr<aoc::Solution> { return std::make_unique<Day2>(r); }},
+        {3, [](std::pmr::memory_resource* r) -> std::unique_ptr<aoc::Solution> { return std::make_unique<Day3>(r); }},
+        {4, [](std::pmr::memory_resource* r) -> std::unique_ptr<aoc::Solution> { return std::make_unique<Day4>(r); }},
+        {5, [](std::pmr::memory_resource* r) -> std::unique_ptr<aoc::Solution> { return std::make_unique<Day5>(r); }},
+    };
+
+    printf("%-4s %-24s %12s %12s\n", "day", "variant", "allocations", "MB");
+    for (const auto& [day, make] : days) {
+        const std::string filename = data_dir + "/24day" + std::to_string(day) + ".txt";
+        if (access(filename.c_str(), R_OK) != 0) {
+            fprintf(stderr, "Day %d: missing puzzle input '%s'\n", day, filename.c_str());
+            continue;
+        }
+        const aoc::Input input(filename.c_str());
+
+        if (day == 2) {
+            report(day, "per line (parse only)", count_allocations([&]() {
+                       aoc::bench::do_not_optimize(per_line_reports(filename.c_str()));
+                   }));
+        } else if (day == 5) {
+            report(day, "per line (parse only)", count_allocations([&]() {
+                       aoc::bench::do_not_optimize(per_line_rules_and_updates(filename.c_str()));
+                   }));
+        }
+
+        report(day, "default heap", count_allocations([&]() {
+                   const auto solution = make(std::pmr::get_default_resource());
+                   run_twice(*solution, input.view());
+               }));
+
+        std::size_t arena_allocations = 0;
+        report(day, "arena", count_allocations([&]() {
+                   aoc::Arena arena;
+                   const auto solution = make(arena.resource());
+                   run_twice(*solution, input.view());
+                   arena_allocations = arena.num_allocations();
+               }));
+        printf("%-4d %-24s %12zu\n", day, "  of which arena buffers", arena_allocations);
+    }
+
+    return 0;
+}
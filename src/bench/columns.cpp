@@ -0,0 +1,139 @@
+#include <array>
+#include <cstdlib>
+#include <random>
+
+#include "bench.h"
+#include "columns.h"
+#include "common.h"
+#include "io.h"
+
+/**
+ * Sink that only sums the integers, to measure the scan itself.
+ */
+struct SumSink {
+    long long sum = 0;
+    void value(int n) { sum += n; }
+    void end_row(std::size_t) {}
+};
+
+/**
+ * Run the scan alone for every supported SIMD level.
+ */
+void bench_scan(const std::string& text, int reps)
+{
+    for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42, aoc::simd::Level::avx2}) {
+        if (level > aoc::simd::best_level()) {
+            continue;
+        }
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            SumSink sink;
+            aoc::detail::scan_ints(text, sink, level);
+            aoc::bench::do_not_optimize(sink.sum);
+        });
+        const std::string name = std::string("scan only (") + aoc::simd::to_string(level) + ")";
+        aoc::bench::report(name.c_str(), seconds, text.size());
+    }
+}
+
+/**
+ * Benchmark parsing generated day 1 lists and day 2 reports with the
+ * vectorized column parser, against splitting each line.
+ *
+ * Usage: bench/columns [num_lines]
+ */
+int main(int argc, char** argv)
+{
+    const int num_lines = argc > 1 ? std::atoi(argv[1]) : 10'000'000;
+    const int reps = 3;
+
+    std::mt19937 rng(0);
+
+    // day 1: two columns of 5-digit location IDs
+    {
+        std::string text;
+        std::uniform_int_distribution<int> id(10000, 99999);
+        for (int i = 0; i < num_lines; ++i) {
+            text += std::to_string(id(rng)) + "   " + std::to_string(id(rng)) + '\n';
+        }
+        printf("day 1: %d lines, %.1f MB\n", num_lines, text.size() / 1e6);
+
+        std::vector<int> expected;
+        {
+            const double seconds = aoc::bench::best_of(reps, [&]() {
+                std::vector<int> left_list;
+                std::vector<int> right_list;
+                for (const auto line : aoc::Lines(text)) {
+                    const auto parts = aoc::split(line, "   ");
+                    left_list.push_back(std::stoi(parts[0]));
+                    right_list.push_back(std::stoi(parts[1]));
+                }
+                aoc::bench::do_not_optimize(left_list.data());
+                aoc::bench::do_not_optimize(right_list.data());
+                expected = std::move(right_list);
+            });
+            aoc::bench::report("split + stoi", seconds, text.size());
+        }
+
+        for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42, aoc::simd::Level::avx2}) {
+            if (level > aoc::simd::best_level()) {
+                continue;
+            }
+            std::array<std::vector<int>, 2> lists;
+            const double seconds = aoc::bench::best_of(reps, [&]() {
+                lists = aoc::parse_columns<2>(text, level);
+                aoc::bench::do_not_optimize(lists[0].data());
+            });
+            assert(lists[1] == expected);
+            const std::string name = std::string("parse_columns (") + aoc::simd::to_string(level) + ")";
+            aoc::bench::report(name.c_str(), seconds, text.size());
+        }
+        bench_scan(text, reps);
+    }
+
+    // day 2: rows of 5 to 8 levels
+    {
+        std::string text;
+        std::uniform_int_distribution<int> num_levels(5, 8);
+        std::uniform_int_distribution<int> level(1, 99);
+        for (int i = 0; i < num_lines; ++i) {
+            const int n = num_levels(rng);
+            for (int j = 0; j < n; ++j) {
+                text += std::to_string(level(rng)) + (j == n - 1 ? '\n' : ' ');
+            }
+        }
+        printf("day 2: %d lines, %.1f MB\n", num_lines, text.size() / 1e6);
+
+        std::vector<std::vector<int>> expected;
+        {
+            const double seconds = aoc::bench::best_of(reps, [&]() {
+                std::vector<std::vector<int>> reports;
+                for (const auto line : aoc::Lines(text)) {
+                    reports.emplace_back(aoc::stoi(aoc::split(line, " ")));
+                }
+                aoc::bench::do_not_optimize(reports.data());
+                expected = std::move(reports);
+            });
+            aoc::bench::report("split + stoi", seconds, text.size());
+        }
+
+        for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42, aoc::simd::Level::avx2}) {
+            if (level > aoc::simd::best_level()) {
+                continue;
+            }
+            aoc::Ragged<int> reports;
+            const double seconds = aoc::bench::best_of(reps, [&]() {
+                reports = aoc::parse_rows(text, level);
+                aoc::bench::do_not_optimize(reports.size());
+            });
+            assert(reports.size() == expected.size());
+            for (std::size_t i = 0; i < reports.size(); ++i) {
+                assert(std::equal(reports[i].begin(), reports[i].end(), expected[i].begin(), expected[i].end()));
+            }
+            const std::string name = std::string("parse_rows (") + aoc::simd::to_string(level) + ")";
+            aoc::bench::report(name.c_str(), seconds, text.size());
+        }
+        bench_scan(text, reps);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <compare>
+#include <cstdlib>
+#include <random>
+
+#include "bench.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day2.cpp"
+
+/**
+ * Copy a report with ith level removed.
+ */
+std::vector<int> reference_copy_exclude_ith(std::span<const int> report, int i)
+{
+    std::vector<int> new_report(report.begin(), report.end());
+    new_report.erase(new_report.begin() + i);
+    return new_report;
+}
+
+/**
+ * Safety check of the original solution, which computes all comparisons and
+ * differences and retries with copies of the report when a level is bad.
+ * Used as the baseline and to check the single-pass version.
+ */
+bool reference_is_safe(std::span<const int> report, bool can_tolerate = false)
+{
+    std::vector<std::strong_ordering> comparisons(report.size() - 1, std::strong_ordering::equal);
+    std::vector<int> differences(report.size() - 1);
+    for (int i = 0; i <= report.size() - 2; ++i) {
+        comparisons[i] = report[i] <=> report[i + 1];
+        differences[i] = abs(report[i] - report[i + 1]);
+    }
+
+    for (int i = 0; i < differences.size(); ++i) {
+        if (differences[i] == 0 || differences[i] > 3) {
+            if (can_tolerate) {
+                return reference_is_safe(reference_copy_exclude_ith(report, i)) ||
+                       reference_is_safe(reference_copy_exclude_ith(report, i + 1));
+            } else {
+                return false;
+            }
+        }
+    }
+
+    for (int i = 1; i < differences.size(); ++i) {
+        if (comparisons[i] != comparisons[i - 1]) {
+            if (can_tolerate) {
+                return reference_is_safe(reference_copy_exclude_ith(report, i - 1)) ||
+                       reference_is_safe(reference_copy_exclude_ith(report, i)) ||
+                       reference_is_safe(reference_copy_exclude_ith(report, i + 1));
+            } else {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Benchmark checking generated reports of 5 to 8 levels. Reports start out
+ * safe, and then have 0, 1, or 2 of their levels replaced at random, so that
+ * all three outcomes are common.
+ *
+ * Usage: bench/day2 [num_reports]
+ */
+int main(int argc, char** argv)
+{
+    const int num_reports = argc > 1 ? std::atoi(argv[1]) : 10'000'000;
+    const int reps = 3;
+
+    aoc::Ragged<int> reports;
+    {
+        std::mt19937 rng(0);
+        std::uniform_int_distribution<int> length_dist(5, 8);
+        std::uniform_int_distribution<int> start_dist(1, 99);
+        std::uniform_int_distribution<int> step_dist(1, 3);
+        std::uniform_int_distribution<int> num_bad_dist(0, 2);
+        std::vector<int> report;
+        reports.reserve(num_reports, num_reports * 8ull);
+        for (int i = 0; i < num_reports; ++i) {
+            const int length = length_dist(rng);
+            const int sign = rng() % 2 ? 1 : -1;
+            report.assign(1, start_dist(rng));
+            while (report.size() < length) {
+                report.push_back(report.back() + sign * step_dist(rng));
+            }
+            for (int j = num_bad_dist(rng); j > 0; --j) {
+                report[rng() % length] = start_dist(rng);
+            }
+            reports.push_row(report);
+        }
+    }
+    printf("%zu reports, %zu levels\n", reports.size(), reports.num_values());
+
+    SafeCounts expected;
+    {
+        const double seconds = aoc::bench::best_of(1, [&]() {
+            expected = {};
+            for (const auto report : reports) {
+                expected.safe += reference_is_safe(report, false);
+                expected.safe_with_removal += reference_is_safe(report, true);
+            }
+        });
+        aoc::bench::report_rate("reference is_safe", seconds, num_reports, "reports");
+    }
+
+    SafeCounts counts;
+    {
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            counts = count_safe(reports);
+            aoc::bench::do_not_optimize(counts);
+        });
+        aoc::bench::report_rate("count_safe", seconds, num_reports, "reports");
+    }
+    for (const auto report : reports) {
+        const Safety safety = check_report(report);
+        assert(safety.safe == reference_is_safe(report, false));
+        assert(safety.safe_with_removal == reference_is_safe(report, true));
+    }
+    assert(counts.safe == expected.safe);
+    assert(counts.safe_with_removal == expected.safe_with_removal);
+    printf("%lld safe, %lld safe with removal\n", counts.safe, counts.safe_with_removal);
+
+    return 0;
+}
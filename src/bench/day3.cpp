@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <random>
+#include <regex>
+
+#include "bench.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day3.cpp"
+
+/**
+ * Regex search of the original solution, which compiles its patterns on every
+ * call. Used as the baseline and to check the scanner.
+ */
+namespace reference
+{
+
+long long sum_mul(const std::string& line)
+{
+    const std::regex re("mul\\((\\d{1,3}),(\\d{1,3})\\)");
+    const std::sregex_iterator begin(line.begin(), line.end(), re);
+    const std::sregex_iterator end;
+
+    long long sum = 0;
+    for (std::sregex_iterator it = begin; it != end; ++it) {
+        sum += std::stoi((*it)[1].str()) * std::stoi((*it)[2].str());
+    }
+    return sum;
+}
+
+long long sum_enabled(std::string line)
+{
+    const std::regex re("do\\(\\)|don't\\(\\)");
+    long long sum = 0;
+    bool enabled = true;
+    std::smatch m;
+    while (std::regex_search(line, m, re)) {
+        if (enabled) {
+            sum += sum_mul(m.prefix());
+        }
+        enabled = m.str().size() == 4;  // do()
+        line = m.suffix().str();
+    }
+    return enabled ? sum + sum_mul(line) : sum;
+}
+
+}  // namespace reference
+
+/**
+ * Benchmark scanning generated corrupted memory for instructions, with the
+ * state machine alone and with the compile-time literal matchers.
+ *
+ * Usage: bench/day3 [megabytes]
+ */
+int main(int argc, char** argv)
+{
+    const double megabytes = argc > 1 ? std::atof(argv[1]) : 100;
+    const int reps = 3;
+
+    // like the generator: a fifth of the tokens are instructions, the rest
+    // are noise, including broken instructions
+    std::string memory;
+    {
+        static const std::string_view NOISE[] = {
+            "mul(", "mul(1,", "mul[2,3]", "do(", "don't", "what()", "(", ")", ",", "m", "d", "'", "!", " ", "x",
+        };
+        std::mt19937 rng(0);
+        std::uniform_int_distribution<int> number(1, 999);
+        while (memory.size() < megabytes * 1e6) {
+            if (rng() % 5 == 0) {
+                switch (rng() % 4) {
+                    case 0:
+                        memory += "do()";
+                        break;
+                    case 1:
+                        memory += "don't()";
+                        break;
+                    default:
+                        memory += "mul(" + std::to_string(number(rng)) + "," + std::to_string(number(rng)) + ")";
+                        break;
+                }
+            } else {
+                memory += NOISE[rng() % std::size(NOISE)];
+            }
+        }
+    }
+    printf("%.1f MB of memory\n", memory.size() / 1e6);
+
+    // the regexes are too slow to run on all of the memory
+    {
+        const std::string sample = memory.substr(0, memory.size() / 100);
+        long long expected_all = 0;
+        long long expected_enabled = 0;
+        const double seconds = aoc::bench::best_of(1, [&]() {
+            expected_all = reference::sum_mul(sample);
+            expected_enabled = reference::sum_enabled(sample);
+        });
+        aoc::bench::report("reference regex", seconds, sample.size());
+
+        Scanner scanner;
+        scanner.feed(sample);
+        scanner.finish("");
+        assert(scanner.sum_all() == expected_all);
+        assert(scanner.sum_enabled() == expected_enabled);
+    }
+
+    Scanner expected;
+    aoc::bench::report("state machine", aoc::bench::best_of(reps, [&]() {
+                           expected = Scanner();
+                           expected.feed<false>(memory);
+                           aoc::bench::do_not_optimize(expected);
+                       }),
+                       memory.size());
+
+    Scanner scanner;
+    aoc::bench::report("literal matchers", aoc::bench::best_of(reps, [&]() {
+                           scanner = Scanner();
+                           scanner.feed(memory);
+                           aoc::bench::do_not_optimize(scanner);
+                       }),
+                       memory.size());
+    assert(scanner.sum_all() == expected.sum_all());
+    assert(scanner.sum_enabled() == expected.sum_enabled());
+
+    return 0;
+}
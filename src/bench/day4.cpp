@@ -0,0 +1,290 @@
+#include <cstdlib>
+#include <random>
+
+#include "bench.h"
+#include "bitplanes.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day4.cpp"
+
+/**
+ * Brute-force search of the original solution, over a `vector<vector<char>>`
+ * walked column by column with bounds checks. Used as the baseline and to
+ * check the other implementations.
+ */
+namespace reference
+{
+
+using Puzzle = std::vector<std::vector<char>>;
+
+Puzzle read_puzzle(std::string_view text)
+{
+    Puzzle puzzle;
+    for (const auto line : aoc::Lines(text)) {
+        puzzle.emplace_back(line.begin(), line.end());
+    }
+    return puzzle;
+}
+
+int count_xmas(const Puzzle& puzzle)
+{
+    static const std::array<char, 4> KEYWORD = {{'X', 'M', 'A', 'S'}};
+    static const std::array<std::array<int, 2>, 8> DIRECTIONS = {{
+        {1, 0},
+        {1, 1},
+        {0, 1},
+        {-1, 1},
+        {-1, 0},
+        {-1, -1},
+        {0, -1},
+        {1, -1},
+    }};
+
+    const int nrows = puzzle.size();
+    const int ncols = puzzle[0].size();
+
+    auto search = [&](int x, int y, int dx, int dy) -> bool {
+        for (auto c : KEYWORD) {
+            if (x < 0 || x >= ncols || y < 0 || y >= nrows) {
+                return false;
+            }
+            if (puzzle[y][x] != c) {
+                return false;
+            }
+            x += dx;
+            y += dy;
+        }
+        return true;
+    };
+
+    int count = 0;
+    for (int x = 0; x < ncols; ++x) {
+        for (int y = 0; y < nrows; ++y) {
+            for (const auto& dir : DIRECTIONS) {
+                if (search(x, y, dir[0], dir[1])) {
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+int count_x_mas(const Puzzle& puzzle)
+{
+    const int nrows = puzzle.size();
+    const int ncols = puzzle[0].size();
+
+    static const std::array<std::array<int, 2>, 4> DIRECTIONS = {{
+        {1, 1},
+        {-1, 1},
+        {-1, -1},
+        {1, -1},
+    }};
+
+    auto search = [&](int x, int y) -> bool {
+        if (x <= 0 || x >= ncols - 1 || y <= 0 || y >= nrows - 1) {
+            return false;
+        }
+        if (puzzle[y][x] != 'A') {
+            return false;
+        }
+
+        std::vector<char> corners(4);
+        for (int i = 0; i < corners.size(); ++i) {
+            const auto& dir = DIRECTIONS[i];
+            corners[i] = puzzle[y + dir[1]][x + dir[0]];
+        }
+
+        int num_m = 0;
+        int num_s = 0;
+        for (char c : corners) {
+            if (c == 'M') {
+                ++num_m;
+            } else if (c == 'S') {
+                ++num_s;
+            }
+        }
+        if (num_m != 2 || num_s != 2) {
+            return false;
+        }
+
+        int num_switches = 0;
+        char prev = corners[3];
+        for (char c : corners) {
+            if (c != prev) {
+                ++num_switches;
+            }
+            prev = c;
+        }
+        return num_switches == 2;
+    };
+
+    int count = 0;
+    for (int x = 1; x < ncols - 1; ++x) {
+        for (int y = 1; y < nrows - 1; ++y) {
+            if (search(x, y)) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Scalar search of the padded grid that loops over the keyword as a runtime
+ * array, as before the search was specialized for "XMAS" at compile time.
+ */
+int count_xmas_runtime_keyword(const ::Puzzle& puzzle)
+{
+    static const std::array<char, 4> KEYWORD = {{'X', 'M', 'A', 'S'}};
+    const auto steps = direction_steps(puzzle);
+
+    int count = 0;
+    for (int y = 0; y < puzzle.nrows(); ++y) {
+        const char* row = puzzle.grid.ptr(0, y);
+        for (int x = 0; x < puzzle.ncols(); ++x) {
+            for (auto step : steps) {
+                const char* p = row + x;
+                bool found = true;
+                for (int k = 0; k < KEYWORD.size() && found; ++k) {
+                    found = *p == KEYWORD[k];
+                    p += step;
+                }
+                count += found;
+            }
+        }
+    }
+    return count;
+}
+
+}  // namespace reference
+
+std::string random_grid(int nrows, int ncols, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> letter(0, 3);
+    std::string text;
+    text.reserve(nrows * (ncols + 1));
+    for (int y = 0; y < nrows; ++y) {
+        for (int x = 0; x < ncols; ++x) {
+            text += "XMAS"[letter(rng)];
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+/**
+ * Benchmark the day 4 word search on a generated square grid of letters.
+ *
+ * Usage: bench/day4 [size]
+ */
+int main(int argc, char** argv)
+{
+    const int size = argc > 1 ? std::atoi(argv[1]) : 10'000;
+    const int reps = 3;
+
+    std::mt19937 rng(0);
+
+    // check the bitplanes against brute force on small grids, including rows
+    // that end inside, at the edge of and just past a word
+    for (const int nrows : {1, 2, 3, 4, 7, 50}) {
+        for (const int ncols : {1, 3, 4, 5, 63, 64, 65, 127, 128, 130}) {
+            const std::string text = random_grid(nrows, ncols, rng);
+            const auto ref_puzzle = reference::read_puzzle(text);
+            const aoc::LetterPlanes<KEYWORD> planes(text);
+            for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42}) {
+                if (level > aoc::simd::best_level()) {
+                    continue;
+                }
+                assert(aoc::count_word<KEYWORD>(planes, level) == reference::count_xmas(ref_puzzle));
+                assert(aoc::count_cross<"MAS">(planes, level) == reference::count_x_mas(ref_puzzle));
+            }
+        }
+    }
+
+    const std::string text = random_grid(size, size, rng);
+    printf("%d x %d grid, %.1f MB\n", size, size, text.size() / 1e6);
+
+    const auto ref_puzzle = reference::read_puzzle(text);
+    const Puzzle puzzle(text);
+
+    int expected1 = 0;
+    int expected2 = 0;
+    aoc::bench::report("reference part 1", aoc::bench::best_of(reps, [&]() {
+                           expected1 = reference::count_xmas(ref_puzzle);
+                           aoc::bench::do_not_optimize(expected1);
+                       }),
+                       text.size());
+    aoc::bench::report("reference part 2", aoc::bench::best_of(reps, [&]() {
+                           expected2 = reference::count_x_mas(ref_puzzle);
+                           aoc::bench::do_not_optimize(expected2);
+                       }),
+                       text.size());
+
+    {
+        int count = 0;
+        aoc::bench::report("part 1 (runtime keyword)", aoc::bench::best_of(reps, [&]() {
+                               count = reference::count_xmas_runtime_keyword(puzzle);
+                               aoc::bench::do_not_optimize(count);
+                           }),
+                           text.size());
+        assert(count == expected1);
+    }
+
+    for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42, aoc::simd::Level::avx2}) {
+        if (level > aoc::simd::best_level()) {
+            continue;
+        }
+        const std::string suffix = std::string(" (") + aoc::simd::to_string(level) + ")";
+
+        int count = 0;
+        aoc::bench::report(("part 1" + suffix).c_str(), aoc::bench::best_of(reps, [&]() {
+                               count = count_xmas(puzzle, level);
+                               aoc::bench::do_not_optimize(count);
+                           }),
+                           text.size());
+        assert(count == expected1);
+        aoc::bench::report(("part 2" + suffix).c_str(), aoc::bench::best_of(reps, [&]() {
+                               count = count_x_mas(puzzle, level);
+                               aoc::bench::do_not_optimize(count);
+                           }),
+                           text.size());
+        assert(count == expected2);
+    }
+
+    // the bitplanes take 4 bits per cell, instead of a byte
+    const aoc::LetterPlanes<KEYWORD> planes(text);
+    printf("bitplanes: %.1f MB, bytes: %.1f MB\n", planes.num_bytes() / 1e6,
+           (puzzle.nrows() + 2 * Puzzle::PADDING) * puzzle.grid.stride() / 1e6);
+
+    aoc::bench::report("read bitplanes", aoc::bench::best_of(reps, [&]() {
+                           const aoc::LetterPlanes<KEYWORD> bits(text);
+                           aoc::bench::do_not_optimize(bits);
+                       }),
+                       text.size());
+
+    // the bitplane kernels only need popcnt, which comes with sse4.2
+    for (auto level : {aoc::simd::Level::scalar, aoc::simd::Level::sse42}) {
+        if (level > aoc::simd::best_level()) {
+            continue;
+        }
+        const std::string suffix = std::string(" (bitplanes, ") + aoc::simd::to_string(level) + ")";
+
+        int count = 0;
+        aoc::bench::report(("part 1" + suffix).c_str(), aoc::bench::best_of(reps, [&]() {
+                               count = aoc::count_word<KEYWORD>(planes, level);
+                               aoc::bench::do_not_optimize(count);
+                           }),
+                           text.size());
+        assert(count == expected1);
+        aoc::bench::report(("part 2" + suffix).c_str(), aoc::bench::best_of(reps, [&]() {
+                               count = aoc::count_cross<"MAS">(planes, level);
+                               aoc::bench::do_not_optimize(count);
+                           }),
+                           text.size());
+        assert(count == expected2);
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+#include "bench.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day5.cpp"
+
+/**
+ * Rule check of the original solution, which scans the update for both pages
+ * of every rule. Used as the baseline and to check the index.
+ */
+bool reference_check_rules(Update update, const std::vector<Rule>& rules)
+{
+    for (const auto& rule : rules) {
+        const auto first = std::find(update.begin(), update.end(), rule.first);
+        const auto second = std::find(update.begin(), update.end(), rule.second);
+        if (first != update.end() && second != update.end() && first > second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Benchmark checking generated updates against generated rules. The rules
+ * are a random subset of a total order over the pages, and the updates are
+ * random subsets of the pages in random order.
+ *
+ * Usage: bench/day5 [num_updates] [num_rules]
+ */
+int main(int argc, char** argv)
+{
+    const int num_updates = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    const int num_rules = argc > 2 ? std::atoi(argv[2]) : 10'000;
+    const int reps = 3;
+
+    // enough pages that the total order has at least `num_rules` pairs
+    int num_pages = 2;
+    while (num_pages * (num_pages - 1) / 2 < num_rules) {
+        ++num_pages;
+    }
+
+    std::mt19937 rng(0);
+    std::vector<int> pages(num_pages);
+    std::iota(pages.begin(), pages.end(), 0);
+    std::shuffle(pages.begin(), pages.end(), rng);
+
+    std::vector<Rule> rules;
+    for (int i = 0; i < num_pages; ++i) {
+        for (int j = i + 1; j < num_pages; ++j) {
+            rules.emplace_back(pages[i], pages[j]);
+        }
+    }
+    std::shuffle(rules.begin(), rules.end(), rng);
+    rules.erase(rules.begin() + num_rules, rules.end());
+
+    aoc::Ragged<int> updates;
+    {
+        std::uniform_int_distribution<int> half_size(2, 11);
+        updates.reserve(num_updates, 12 * num_updates);
+        for (int i = 0; i < num_updates; ++i) {
+            std::shuffle(pages.begin(), pages.end(), rng);
+            updates.push_row(std::span<const int>(pages.data(), 2 * half_size(rng) + 1));
+        }
+    }
+    printf("%d updates, %d rules, %d pages\n", num_updates, num_rules, num_pages);
+
+    // the original check is too slow to run on every update
+    const int num_reference = std::max(1, num_updates / 1000);
+    std::vector<bool> expected(num_reference);
+    {
+        const double seconds = aoc::bench::best_of(1, [&]() {
+            for (int i = 0; i < num_reference; ++i) {
+                expected[i] = reference_check_rules(updates[i], rules);
+            }
+        });
+        aoc::bench::report_rate("reference check_rules", seconds, num_reference, "updates");
+    }
+
+    {
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            const PrecedenceIndex index(rules, num_pages);
+            aoc::bench::do_not_optimize(index);
+        });
+        aoc::bench::report_rate("build index", seconds, num_rules, "rules");
+    }
+
+    const PrecedenceIndex index(rules, num_pages);
+    int num_valid = 0;
+    {
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            num_valid = 0;
+            for (const Update update : updates) {
+                num_valid += index.check(update);
+            }
+            aoc::bench::do_not_optimize(num_valid);
+        });
+        aoc::bench::report_rate("index check", seconds, num_updates, "updates");
+    }
+    for (int i = 0; i < num_reference; ++i) {
+        assert(index.check(updates[i]) == expected[i]);
+    }
+    printf("%d valid updates\n", num_valid);
+
+    // order the incorrectly-ordered updates on one core
+    {
+        std::vector<char> valid(num_updates);
+        for (int i = 0; i < num_updates; ++i) {
+            valid[i] = index.check(updates[i]);
+        }
+
+        OrderScratch scratch;
+        std::vector<int> ordered_update;
+        const auto bench_order = [&](const char* name, auto&& order) {
+            long long sum = 0;
+            const double seconds = aoc::bench::best_of(reps, [&]() {
+                sum = 0;
+                for (int i = 0; i < num_updates; ++i) {
+                    if (!valid[i] && order(updates[i], index, ordered_update, scratch)) {
+                        sum += ordered_update[(ordered_update.size() - 1) / 2];
+                    }
+                }
+                aoc::bench::do_not_optimize(sum);
+            });
+            aoc::bench::report_rate(name, seconds, num_updates - num_valid, "updates");
+            return sum;
+        };
+
+        const long long expected_sum = bench_order("order (Kahn)", order_update);
+        int num_ranked = 0;
+        for (int i = 0; i < num_updates; ++i) {
+            num_ranked += !valid[i] && rank_update(updates[i], index, ordered_update, scratch);
+        }
+        bench_order("order (rank only)", [](Update update, auto&... args) { return rank_update(update, args...); });
+        const long long sum = bench_order("order (rank, else Kahn)", reorder_update);
+        assert(sum == expected_sum);
+        printf("%d of %d updates ordered by rank\n", num_ranked, num_updates - num_valid);
+    }
+
+    // incremental checking of all updates
+
+    IncrementalChecker checker(num_pages);
+    for (const auto& rule : rules) {
+        checker.add_rule(rule);
+    }
+    aoc::bench::report_rate("incremental add update", aoc::bench::wall_time([&]() {
+                                for (const Update update : updates) {
+                                    checker.add_update(update);
+                                }
+                            }),
+                            num_updates, "updates");
+
+    // full recheck of every update, which is what a change of the rules
+    // costs without the reverse index
+    const auto full_check = [&](const std::vector<Rule>& rules) {
+        const PrecedenceIndex index(rules, num_pages);
+        const auto valid = check_updates(updates, index);
+        return std::make_pair(sum_valid_middles(updates, valid), reorder_updates(updates, valid, index).sum_of_middle);
+    };
+    const double full_seconds = aoc::bench::best_of(reps, [&]() { aoc::bench::do_not_optimize(full_check(rules)); });
+    printf("%-32s %10.3f ms\n", "full recheck per rule change", 1e3 * full_seconds);
+
+    // remove and add back random rules
+    const int num_changes = 1'000;
+    const std::size_t checks_before = checker.num_checks();
+    const double seconds = aoc::bench::wall_time([&]() {
+        for (int i = 0; i < num_changes / 2; ++i) {
+            const Rule rule = rules[rng() % rules.size()];
+            checker.remove_rule(rule);
+            checker.add_rule(rule);
+        }
+    });
+    printf("%-32s %10.3f ms\n", "incremental per rule change", 1e3 * seconds / num_changes);
+    printf("%.1f updates rechecked per change\n", double(checker.num_checks() - checks_before) / num_changes);
+
+    // check the totals with a rule removed, and with all rules
+    {
+        const Rule rule = rules.back();
+        rules.pop_back();
+        checker.remove_rule(rule);
+        const auto [valid_sum, reordered_sum] = full_check(rules);
+        assert(checker.sum_valid_middles() == valid_sum);
+        assert(checker.sum_reordered_middles() == reordered_sum);
+
+        rules.push_back(rule);
+        checker.add_rule(rule);
+        const auto [all_valid_sum, all_reordered_sum] = full_check(rules);
+        assert(checker.sum_valid_middles() == all_valid_sum);
+        assert(checker.sum_reordered_middles() == all_reordered_sum);
+    }
+
+    return 0;
+}
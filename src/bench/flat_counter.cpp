@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+#include "sort.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day1.cpp"
+
+/**
+ * Similarity score of the original solution, which counts the right list in
+ * an `std::unordered_map`. Used as the baseline.
+ */
+long long reference_similarity(const std::vector<int>& left_list, const std::vector<int>& right_list)
+{
+    std::unordered_map<int, int> occurrences;
+    for (auto n : right_list) {
+        if (occurrences.contains(n)) {
+            ++occurrences[n];
+        } else {
+            occurrences[n] = 1;
+        }
+    }
+
+    long long similarity = 0;
+    for (auto n : left_list) {
+        if (occurrences.contains(n)) {
+            similarity += static_cast<long long>(n) * occurrences[n];
+        }
+    }
+    return similarity;
+}
+
+/**
+ * Similarity score using a `FlatCounter` of the right list.
+ */
+long long flat_similarity(const std::vector<int>& left_list, const std::vector<int>& right_list)
+{
+    const auto occurrences = aoc::FlatCounter::count(right_list);
+    long long similarity = 0;
+    for (auto n : left_list) {
+        similarity += static_cast<long long>(n) * occurrences[n];
+    }
+    return similarity;
+}
+
+/**
+ * Benchmark the similarity score of two lists of `n` values, each drawn from
+ * `num_distinct` random values in `[min, max]`.
+ */
+void bench_similarity(std::size_t n, const char* label, int min, int max, std::size_t num_distinct)
+{
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> value_dist(min, max);
+    std::vector<int> distinct(num_distinct);
+    for (auto& x : distinct) {
+        x = value_dist(rng);
+    }
+    std::uniform_int_distribution<std::size_t> index_dist(0, num_distinct - 1);
+    std::vector<int> left_list(n);
+    std::vector<int> right_list(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        left_list[i] = distinct[index_dist(rng)];
+        right_list[i] = distinct[index_dist(rng)];
+    }
+
+    char name[64];
+    long long expected = 0;
+    snprintf(name, sizeof(name), "unordered_map %s", label);
+    const double reference_seconds =
+        aoc::bench::best_of(1, [&]() { expected = reference_similarity(left_list, right_list); });
+    aoc::bench::report_rate(name, reference_seconds, n, "values");
+
+    long long similarity = 0;
+    snprintf(name, sizeof(name), "FlatCounter %s", label);
+    const double seconds = aoc::bench::best_of(3, [&]() {
+        similarity = flat_similarity(left_list, right_list);
+        aoc::bench::do_not_optimize(similarity);
+    });
+    aoc::bench::report_rate(name, seconds, n, "values");
+    assert(similarity == expected);
+
+    // the day 1 lists are already sorted by part 1
+    aoc::sort_ints(left_list);
+    aoc::sort_ints(right_list);
+
+    snprintf(name, sizeof(name), "count_sorted %s", label);
+    const double sorted_seconds = aoc::bench::best_of(3, [&]() {
+        const auto occurrences = aoc::FlatCounter::count_sorted(right_list);
+        similarity = 0;
+        for (auto n : left_list) {
+            similarity += static_cast<long long>(n) * occurrences[n];
+        }
+        aoc::bench::do_not_optimize(similarity);
+    });
+    aoc::bench::report_rate(name, sorted_seconds, n, "values");
+    assert(similarity == expected);
+
+    snprintf(name, sizeof(name), "merge-join %s", label);
+    const double merge_seconds = aoc::bench::best_of(3, [&]() {
+        similarity = sorted_similarity(left_list, right_list);
+        aoc::bench::do_not_optimize(similarity);
+    });
+    aoc::bench::report_rate(name, merge_seconds, n, "values");
+    assert(similarity == expected);
+}
+
+/**
+ * Benchmark the day 1 similarity score on lists of 5-digit location IDs,
+ * which get a dense counter, and on lists of values spread over the 32-bit
+ * range, which get a hash table counter.
+ *
+ * Usage: bench/flat_counter [n...]
+ */
+int main(int argc, char** argv)
+{
+    std::vector<std::size_t> sizes = {1'000'000, 10'000'000, 100'000'000};
+    if (argc > 1) {
+        sizes.assign(argc - 1, 0);
+        for (int i = 1; i < argc; ++i) {
+            sizes[i - 1] = std::atoll(argv[i]);
+        }
+    }
+
+    for (const std::size_t n : sizes) {
+        printf("n = %zu\n", n);
+        bench_similarity(n, "5-digit", 10000, 99999, 90000);
+        bench_similarity(n, "sparse", -1'000'000'000, 1'000'000'000, std::max<std::size_t>(1, n / 10));
+    }
+
+    return 0;
+}
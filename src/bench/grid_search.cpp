@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <random>
+
+#include "bench.h"
+
+#define AOC_NO_MAIN
+#include "../aoc/24day4.cpp"
+
+/**
+ * Count the number of times `word` appears in any direction, by brute force.
+ */
+long long brute_force_count(const Puzzle& puzzle, const std::string& word)
+{
+    long long count = 0;
+    for (int y = 0; y < puzzle.nrows(); ++y) {
+        for (int x = 0; x < puzzle.ncols(); ++x) {
+            for (const auto& dir : DIRECTIONS) {
+                bool found = true;
+                for (int k = 0; k < word.size() && found; ++k) {
+                    const int xk = x + k * dir[0];
+                    const int yk = y + k * dir[1];
+                    found = xk >= 0 && xk < puzzle.ncols() && yk >= 0 && yk < puzzle.nrows() && puzzle.at(xk, yk) == word[k];
+                }
+                count += found;
+            }
+        }
+    }
+    return count;
+}
+
+std::string random_grid(int size, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> letter(0, 3);
+    std::string text;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            text += "XMAS"[letter(rng)];
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+std::vector<std::string> random_words(int num_words, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> letter(0, 3);
+    std::uniform_int_distribution<int> length(3, 10);
+    std::vector<std::string> words = {"XMAS"};
+    while (words.size() < num_words) {
+        std::string word(length(rng), ' ');
+        for (auto& c : word) {
+            c = "XMAS"[letter(rng)];
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+/**
+ * Benchmark searching a generated grid for many words at once with the
+ * Aho-Corasick grid search.
+ *
+ * Usage: bench/grid_search [size]
+ */
+int main(int argc, char** argv)
+{
+    const int size = argc > 1 ? std::atoi(argv[1]) : 2'000;
+    const int reps = 3;
+
+    std::mt19937 rng(0);
+
+    // check against brute force on a small grid
+    {
+        const Puzzle puzzle(random_grid(50, rng));
+        const auto words = random_words(200, rng);
+        const auto counts = count_words(puzzle, words);
+
+        std::vector<long long> match_counts(words.size(), 0);
+        const aoc::AhoCorasick automaton(words);
+        aoc::find_in_grid(automaton, puzzle.grid, [&](const aoc::GridMatch& match) {
+            const auto& word = words[match.pattern];
+            for (int k = 0; k < word.size(); ++k) {
+                assert(puzzle.at(match.x + k * match.dx, match.y + k * match.dy) == word[k]);
+            }
+            ++match_counts[match.pattern];
+        });
+
+        for (int i = 0; i < words.size(); ++i) {
+            assert(counts[i] == brute_force_count(puzzle, words[i]));
+            assert(match_counts[i] == counts[i]);
+        }
+        assert(counts[0] == count_xmas(puzzle));
+    }
+
+    const std::string text = random_grid(size, rng);
+    const Puzzle puzzle(text);
+    printf("%d x %d grid, %.1f MB\n", size, size, text.size() / 1e6);
+
+    for (int num_words : {1, 10, 100, 1'000, 10'000, 100'000}) {
+        const auto words = random_words(num_words, rng);
+        std::vector<long long> counts;
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            counts = count_words(puzzle, words);
+            aoc::bench::do_not_optimize(counts.data());
+        });
+        assert(counts[0] == count_xmas(puzzle));
+
+        const std::string name = std::to_string(num_words) + " words";
+        aoc::bench::report(name.c_str(), seconds, text.size());
+    }
+
+    return 0;
+}
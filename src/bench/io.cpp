@@ -0,0 +1,88 @@
+#include <array>
+#include <cstdlib>
+#include <random>
+
+#include "bench.h"
+#include "common.h"
+#include "io.h"
+
+/**
+ * Benchmark the line splitting and integer parsing helpers on generated
+ * lines of space-separated integers, like the day 2 reports.
+ *
+ * Usage: bench/io [num_lines]
+ */
+int main(int argc, char** argv)
+{
+    const int num_lines = argc > 1 ? std::atoi(argv[1]) : 10'000'000;
+    const int reps = 3;
+
+    std::string text;
+    {
+        std::mt19937 rng(0);
+        std::uniform_int_distribution<int> num_levels(5, 8);
+        std::uniform_int_distribution<int> level(1, 99);
+        for (int i = 0; i < num_lines; ++i) {
+            const int n = num_levels(rng);
+            for (int j = 0; j < n; ++j) {
+                if (j > 0) {
+                    text += ' ';
+                }
+                text += std::to_string(level(rng));
+            }
+            text += '\n';
+        }
+    }
+    const aoc::Lines lines(text);
+
+    printf("%d lines, %.1f MB\n", num_lines, text.size() / 1e6);
+
+    long long expected = 0;
+    {
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            long long sum = 0;
+            for (const auto line : lines) {
+                for (int n : aoc::stoi(aoc::split(line, " "))) {
+                    sum += n;
+                }
+            }
+            aoc::bench::do_not_optimize(sum);
+            expected = sum;
+        });
+        aoc::bench::report("split + stoi", seconds, text.size());
+    }
+
+    {
+        long long sum = 0;
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            sum = 0;
+            for (const auto line : lines) {
+                for (const auto part : aoc::split_view(line, " ")) {
+                    sum += aoc::parse_int(part);
+                }
+            }
+            aoc::bench::do_not_optimize(sum);
+        });
+        assert(sum == expected);
+        aoc::bench::report("split_view + parse_int", seconds, text.size());
+    }
+
+    {
+        long long sum = 0;
+        const double seconds = aoc::bench::best_of(reps, [&]() {
+            sum = 0;
+            std::array<int, 64> levels;
+            for (const auto line : lines) {
+                const auto n = aoc::parse_ints(line, ' ', levels);
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += levels[i];
+                }
+            }
+            aoc::bench::do_not_optimize(sum);
+        });
+        assert(sum == expected);
+        aoc::bench::report("parse_ints", seconds, text.size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "sort.h"
+
+/**
+ * Benchmark sorting `n` random values in `[min, max]` with `std::sort` and
+ * `aoc::sort_ints`, and check that the results agree.
+ */
+void bench_sort(std::size_t n, const char* label, int min, int max)
+{
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> dist(min, max);
+    std::vector<int> values(n);
+    for (auto& x : values) {
+        x = dist(rng);
+    }
+
+    std::vector<int> expected;
+    std::vector<int> sorted;
+    char name[64];
+
+    snprintf(name, sizeof(name), "std::sort %s", label);
+    const double sort_seconds = aoc::bench::best_of(1, [&]() {
+        expected = values;
+        std::sort(expected.begin(), expected.end());
+    });
+    aoc::bench::report_rate(name, sort_seconds, n, "values");
+
+    snprintf(name, sizeof(name), "sort_ints %s", label);
+    const double seconds = aoc::bench::best_of(3, [&]() {
+        sorted = values;
+        aoc::sort_ints(sorted);
+        aoc::bench::do_not_optimize(sorted.data());
+    });
+    aoc::bench::report_rate(name, seconds, n, "values");
+
+    assert(sorted == expected);
+}
+
+/**
+ * Benchmark sorting lists like the day 1 location IDs, which are 5-digit
+ * numbers, and lists of arbitrary 32-bit values.
+ *
+ * Usage: bench/sort [n...]
+ */
+int main(int argc, char** argv)
+{
+    std::vector<std::size_t> sizes = {1'000'000, 10'000'000, 100'000'000};
+    if (argc > 1) {
+        sizes.assign(argc - 1, 0);
+        for (int i = 1; i < argc; ++i) {
+            sizes[i - 1] = std::atoll(argv[i]);
+        }
+    }
+
+    for (const std::size_t n : sizes) {
+        printf("n = %zu\n", n);
+        bench_sort(n, "5-digit", 10000, 99999);
+        bench_sort(n, "int32", -1'000'000'000, 1'000'000'000);
+    }
+
+    return 0;
+}
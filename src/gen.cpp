@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common.h"
+#include "io.h"
+
+/**
+ * Buffered output that counts the bytes written, so that generators can stop
+ * at a size target.
+ */
+class Writer
+{
+public:
+    explicit Writer(FILE* file) : file(file) { buffer.reserve(CAPACITY); }
+
+    ~Writer() { flush(); }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    std::size_t bytes_written() const { return num_bytes; }
+
+    void write(std::string_view str)
+    {
+        buffer.append(str);
+        num_bytes += str.size();
+        if (buffer.size() >= CAPACITY) {
+            flush();
+        }
+    }
+
+    void write(char c) { write(std::string_view(&c, 1)); }
+
+    void write(long long n)
+    {
+        char digits[24];
+        const int length = snprintf(digits, sizeof(digits), "%lld", n);
+        write(std::string_view(digits, length));
+    }
+
+    void flush()
+    {
+        const std::size_t n = fwrite(buffer.data(), 1, buffer.size(), file);
+        assert(n == buffer.size());
+        buffer.clear();
+    }
+
+private:
+    static constexpr std::size_t CAPACITY = 1 << 20;
+
+    FILE* file;
+    std::string buffer;
+    std::size_t num_bytes = 0;
+};
+
+/**
+ * Options of the generators. Each day uses only some of them.
+ */
+struct Options {
+    std::size_t size = 1 << 20;  // stop after the first record that reaches this many bytes
+    uint64_t seed = 1;
+    double overlap = 0.5;    // day 1: fraction of right IDs that also appear on the left
+    double safe = 0.4;       // day 2: fraction of safe reports
+    double tolerable = 0.3;  // day 2: fraction of reports that are safe after removing a level
+    double density = 0.2;    // day 3: fraction of tokens that are instructions
+    int cols = 140;          // day 4: width of the grid
+    int pages = 49;          // day 5: number of distinct pages
+    double sorted = 0.5;     // day 5: fraction of updates that are correctly ordered
+};
+
+using Rng = std::mt19937_64;
+
+/**
+ * Uniform integer in `[lo, hi]`.
+ */
+int uniform(Rng& rng, int lo, int hi)
+{
+    return lo + static_cast<int>(rng() % static_cast<uint64_t>(hi - lo + 1));
+}
+
+/**
+ * True with probability `p`.
+ */
+bool chance(Rng& rng, double p)
+{
+    return std::uniform_real_distribution<double>(0, 1)(rng) < p;
+}
+
+/**
+ * Day 1: two columns of 5-digit location IDs.
+ */
+void generate_day1(Writer& out, Rng& rng, const Options& options)
+{
+    // remember some left IDs, so that right IDs can repeat them
+    std::vector<int> seen;
+    while (out.bytes_written() < options.size) {
+        const int left = uniform(rng, 10000, 99999);
+        if (seen.size() < (1 << 16)) {
+            seen.push_back(left);
+        } else {
+            seen[rng() % seen.size()] = left;
+        }
+        const int right = chance(rng, options.overlap) ? seen[rng() % seen.size()] : uniform(rng, 10000, 99999);
+
+        out.write(static_cast<long long>(left));
+        out.write("   ");
+        out.write(static_cast<long long>(right));
+        out.write('\n');
+    }
+}
+
+/**
+ * Day 2: reports of 5 to 8 levels. Reports are safe, safe after removing one
+ * repeated level, or have two repeated levels, which makes them unsafe.
+ */
+void generate_day2(Writer& out, Rng& rng, const Options& options)
+{
+    std::vector<int> report;
+    while (out.bytes_written() < options.size) {
+        const double kind = std::uniform_real_distribution<double>(0, 1)(rng);
+        const int num_extra = kind < options.safe ? 0 : kind < options.safe + options.tolerable ? 1 : 2;
+
+        const int length = uniform(rng, 5, 8) - num_extra;
+        const int sign = rng() % 2 ? 1 : -1;
+        report.assign(1, uniform(rng, 1, 99));
+        for (int i = 1; i < length; ++i) {
+            report.push_back(report.back() + sign * uniform(rng, 1, 3));
+        }
+        for (int i = 0; i < num_extra; ++i) {
+            // a repeated level can never be part of a safe report
+            const int j = uniform(rng, 0, report.size() - 1);
+            report.insert(report.begin() + j, report[j]);
+        }
+
+        for (int i = 0; i < report.size(); ++i) {
+            if (i > 0) {
+                out.write(' ');
+            }
+            out.write(static_cast<long long>(report[i]));
+        }
+        out.write('\n');
+    }
+}
+
+/**
+ * Day 3: corrupted memory in lines of about 3000 characters. A fraction of
+ * the tokens are `mul(X,Y)`, `do()` or `don't()` instructions, and the rest are
+ * noise, including broken instructions.
+ */
+void generate_day3(Writer& out, Rng& rng, const Options& options)
+{
+    static const std::string_view NOISE[] = {
+        "mul(", "mul(1,", "mul[2,3]", "mul ( 2 , 4 )", "do(", "don't", "what()", "from()", "select()", "how()",
+        "(",    ")",      ",",        "m",             "u",   "l",     "d",      "o",      "n",        "'",
+        "t",    "!",      "@",        "#",             "$",   "%",     "^",      "&",      "*",        "[",
+        "]",    "{",      "}",        "<",             ">",   "?",     "/",      " ",      "+",        "-",
+    };
+
+    std::size_t line_length = 0;
+    while (out.bytes_written() < options.size) {
+        const std::size_t before = out.bytes_written();
+        if (chance(rng, options.density)) {
+            switch (rng() % 4) {
+                case 0:
+                    out.write("do()");
+                    break;
+                case 1:
+                    out.write("don't()");
+                    break;
+                default:
+                    out.write("mul(");
+                    out.write(static_cast<long long>(uniform(rng, 1, 999)));
+                    out.write(',');
+                    out.write(static_cast<long long>(uniform(rng, 1, 999)));
+                    out.write(')');
+                    break;
+            }
+        } else {
+            out.write(NOISE[rng() % std::size(NOISE)]);
+        }
+
+        line_length += out.bytes_written() - before;
+        if (line_length >= 3000) {
+            out.write('\n');
+            line_length = 0;
+        }
+    }
+    if (line_length > 0) {
+        out.write('\n');
+    }
+}
+
+/**
+ * Day 4: a grid of the letters X, M, A and S, `cols` letters wide.
+ */
+void generate_day4(Writer& out, Rng& rng, const Options& options)
+{
+    static const char LETTERS[] = {'X', 'M', 'A', 'S'};
+
+    std::string row(options.cols + 1, '\n');
+    while (out.bytes_written() < options.size) {
+        for (int x = 0; x < options.cols; ++x) {
+            row[x] = LETTERS[rng() % 4];
+        }
+        out.write(row);
+    }
+}
+
+/**
+ * Day 5: rules for every pair of pages in a random total order, so that they
+ * are consistent, and updates of 5 to 23 distinct pages. A fraction of the
+ * updates are in the order of the rules.
+ */
+void generate_day5(Writer& out, Rng& rng, const Options& options)
+{
+    // pages have at least two digits, like the real input
+    std::vector<int> order(options.pages);
+    std::iota(order.begin(), order.end(), 10);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<int> rank(10 + options.pages);
+    for (int i = 0; i < options.pages; ++i) {
+        rank[order[i]] = i;
+    }
+
+    std::vector<std::pair<int, int>> rules;
+    for (int i = 0; i < options.pages; ++i) {
+        for (int j = i + 1; j < options.pages; ++j) {
+            rules.emplace_back(order[i], order[j]);
+        }
+    }
+    std::shuffle(rules.begin(), rules.end(), rng);
+    for (const auto& [first, second] : rules) {
+        out.write(static_cast<long long>(first));
+        out.write('|');
+        out.write(static_cast<long long>(second));
+        out.write('\n');
+    }
+    out.write('\n');
+
+    const int max_length = std::min(23, options.pages % 2 == 1 ? options.pages : options.pages - 1);
+    std::vector<int> pages = order;
+    do {
+        const int length = 2 * uniform(rng, 2, max_length / 2) + 1;
+        // partial Fisher-Yates shuffle to pick `length` distinct pages
+        for (int i = 0; i < length; ++i) {
+            std::swap(pages[i], pages[uniform(rng, i, options.pages - 1)]);
+        }
+        if (chance(rng, options.sorted)) {
+            std::sort(pages.begin(), pages.begin() + length, [&](int a, int b) { return rank[a] < rank[b]; });
+        }
+
+        for (int i = 0; i < length; ++i) {
+            if (i > 0) {
+                out.write(',');
+            }
+            out.write(static_cast<long long>(pages[i]));
+        }
+        out.write('\n');
+    } while (out.bytes_written() < options.size);
+}
+
+/**
+ * Generates synthetic puzzle inputs of any size, for benchmarking. The output
+ * only depends on the options, including the seed.
+ *
+ * Usage: gen DAY [--size BYTES] [--seed N] [-o FILE] [day options]
+ *
+ * BYTES may have a K, M or G suffix. The day options are
+ *   day 1: --overlap P
+ *   day 2: --safe P, --tolerable P
+ *   day 3: --density P
+ *   day 4: --cols N
+ *   day 5: --pages N, --sorted P
+ * where P is a fraction. See `Options` for their meaning.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s DAY [--size BYTES] [--seed N] [-o FILE] [day options]\n", argv[0]);
+        return 1;
+    }
+    const int day = std::atoi(argv[1]);
+
+    Options options;
+    const char* filename = nullptr;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const std::string_view flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--size") {
+            if (!aoc::parse_size(value, options.size)) {
+                fprintf(stderr, "Invalid size '%s'\n", value);
+                return 1;
+            }
+        } else if (flag == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (flag == "-o") {
+            filename = value;
+        } else if (flag == "--overlap") {
+            options.overlap = std::atof(value);
+        } else if (flag == "--safe") {
+            options.safe = std::atof(value);
+        } else if (flag == "--tolerable") {
+            options.tolerable = std::atof(value);
+        } else if (flag == "--density") {
+            options.density = std::atof(value);
+        } else if (flag == "--cols") {
+            options.cols = std::atoi(value);
+        } else if (flag == "--pages") {
+            options.pages = std::atoi(value);
+        } else if (flag == "--sorted") {
+            options.sorted = std::atof(value);
+        } else {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 1) {
+        fprintf(stderr, "Missing value for option '%s'\n", argv[argc - 1]);
+        return 1;
+    }
+    assert(options.cols > 0);
+    assert(options.pages >= 5);
+
+    FILE* file = filename ? fopen(filename, "w") : stdout;
+    assert(file != nullptr);
+
+    Rng rng(options.seed);
+    {
+        Writer out(file);
+        switch (day) {
+            case 1:
+                generate_day1(out, rng, options);
+                break;
+            case 2:
+                generate_day2(out, rng, options);
+                break;
+            case 3:
+                generate_day3(out, rng, options);
+                break;
+            case 4:
+                generate_day4(out, rng, options);
+                break;
+            case 5:
+                generate_day5(out, rng, options);
+                break;
+            default:
+                fprintf(stderr, "No generator for day %d\n", day);
+                return 1;
+        }
+    }
+
+    if (filename) {
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * Aho-Corasick automaton, for finding many patterns in a text at once.
+ *
+ * The automaton is built as a complete DFA: every state has a transition for
+ * every symbol, so scanning costs one table lookup per character no matter
+ * how many patterns there are. Only characters that appear in some pattern
+ * get their own symbol; all other characters share one.
+ */
+class AhoCorasick
+{
+public:
+    explicit AhoCorasick(const std::vector<std::string>& patterns)
+    {
+        // assign symbols, with 0 being any character not in a pattern
+        symbols.fill(0);
+        num_symbols = 1;
+        for (const auto& pattern : patterns) {
+            for (unsigned char c : pattern) {
+                if (symbols[c] == 0) {
+                    symbols[c] = num_symbols++;
+                }
+            }
+        }
+
+        // build the trie
+        add_state();
+        pattern_states.reserve(patterns.size());
+        pattern_lengths.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            assert(!pattern.empty());
+            int state = 0;
+            for (char c : pattern) {
+                const auto i = state * num_symbols + symbol(c);
+                if (transitions[i] == -1) {
+                    const int next_state = add_state();  // NOTE: reallocates `transitions`
+                    transitions[i] = next_state;
+                }
+                state = transitions[i];
+            }
+            pattern_states.push_back(state);
+            pattern_lengths.push_back(pattern.size());
+        }
+
+        // patterns ending at each state, as a compressed sparse row array
+        pattern_offsets.assign(num_states() + 1, 0);
+        for (int state : pattern_states) {
+            ++pattern_offsets[state + 1];
+        }
+        for (int state = 0; state < num_states(); ++state) {
+            pattern_offsets[state + 1] += pattern_offsets[state];
+        }
+        state_patterns.resize(patterns.size());
+        {
+            auto next = pattern_offsets;
+            for (int i = 0; i < patterns.size(); ++i) {
+                state_patterns[next[pattern_states[i]]++] = i;
+            }
+        }
+
+        // breadth-first search to set the failure links and fill in the
+        // missing transitions, which follow the failure links
+        failures.assign(num_states(), 0);
+        outputs.assign(num_states(), -1);
+        bfs_order.reserve(num_states());
+        bfs_order.push_back(0);
+        for (int i = 0; i < bfs_order.size(); ++i) {
+            const int state = bfs_order[i];
+            const int failure = failures[state];
+            for (int a = 0; a < num_symbols; ++a) {
+                int& next_state = transitions[state * num_symbols + a];
+                const int fallback = state == 0 ? 0 : transitions[failure * num_symbols + a];
+                if (next_state == -1) {
+                    next_state = fallback;
+                } else {
+                    failures[next_state] = fallback;
+                    outputs[next_state] = has_patterns(fallback) ? fallback : outputs[fallback];
+                    bfs_order.push_back(next_state);
+                }
+            }
+        }
+    }
+
+    int num_patterns() const { return pattern_states.size(); }
+    int num_states() const { return transitions.size() / num_symbols; }
+
+    /**
+     * State after reading character `c` in state `state`. The initial state is 0.
+     */
+    int next(int state, char c) const { return transitions[state * num_symbols + symbol(c)]; }
+
+    /**
+     * Call `fn(pattern, length)` for every pattern that ends at the last
+     * character read to reach `state`.
+     */
+    template <typename Fn>
+    void for_each_match(int state, Fn&& fn) const
+    {
+        if (!has_patterns(state)) {
+            state = outputs[state];
+        }
+        for (; state != -1; state = outputs[state]) {
+            for (int i = pattern_offsets[state]; i < pattern_offsets[state + 1]; ++i) {
+                const int pattern = state_patterns[i];
+                fn(pattern, pattern_lengths[pattern]);
+            }
+        }
+    }
+
+    /**
+     * Given the number of times each state was visited while scanning, count
+     * the number of matches of each pattern. A pattern matches whenever a
+     * state whose failure chain passes through the pattern's state is
+     * visited, so the visits are summed up the failure tree.
+     * @param visits Number of visits to each state. Used as scratch space.
+     */
+    std::vector<long long> count_matches(std::vector<long long>& visits) const
+    {
+        assert(visits.size() == num_states());
+        for (int i = bfs_order.size() - 1; i > 0; --i) {
+            const int state = bfs_order[i];
+            visits[failures[state]] += visits[state];
+        }
+
+        std::vector<long long> counts(num_patterns());
+        for (int i = 0; i < num_patterns(); ++i) {
+            counts[i] = visits[pattern_states[i]];
+        }
+        return counts;
+    }
+
+private:
+    std::array<uint16_t, 256> symbols;  // up to 256 bytes, plus the "other" symbol 0
+    int num_symbols;
+
+    std::vector<int> transitions;  // num_states x num_symbols
+    std::vector<int> failures;
+    std::vector<int> outputs;  // nearest state on the failure chain where a pattern ends, or -1
+    std::vector<int> bfs_order;
+
+    std::vector<int> pattern_states;
+    std::vector<int> pattern_lengths;
+    std::vector<int> pattern_offsets;
+    std::vector<int> state_patterns;
+
+    int symbol(char c) const { return symbols[static_cast<unsigned char>(c)]; }
+
+    bool has_patterns(int state) const { return pattern_offsets[state] != pattern_offsets[state + 1]; }
+
+    int add_state()
+    {
+        transitions.resize(transitions.size() + num_symbols, -1);
+        return num_states() - 1;
+    }
+};
+
+}  // namespace aoc
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <memory_resource>
+
+namespace aoc
+{
+
+/**
+ * Memory resource that forwards to another one, and counts the allocations
+ * made through it.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream)
+    {
+    }
+
+    std::size_t num_allocations() const { return allocations; }
+    std::size_t num_bytes() const { return bytes; }
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override
+    {
+        ++allocations;
+        bytes += size;
+        return upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment) override
+    {
+        upstream->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream;
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Monotonic arena for the data of a whole run. Memory is only released when
+ * the arena is destroyed, which makes allocating from it a pointer bump.
+ *
+ * The arena starts with a small buffer, and adds geometrically larger buffers
+ * when it runs out, so it does only a handful of allocations and never holds
+ * much more than the data put in it. Containers that are sized up front, e.g.
+ * with `reserve`, get a buffer of their own. Containers whose elements are
+ * themselves containers, e.g. `std::pmr::vector<std::pmr::string>`, pass the
+ * arena down to their elements.
+ */
+class Arena
+{
+public:
+    static constexpr std::size_t INITIAL_SIZE = 1 << 16;
+
+    explicit Arena(std::size_t initial_size = INITIAL_SIZE) : arena(std::max<std::size_t>(initial_size, 1), &upstream)
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    /**
+     * Number of buffers the arena allocated, and their total size.
+     */
+    std::size_t num_allocations() const { return upstream.num_allocations(); }
+    std::size_t num_bytes() const { return upstream.num_bytes(); }
+
+private:
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource arena;
+};
+
+}  // namespace aoc
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace aoc::bench
+{
+
+/**
+ * Prevent the compiler from optimizing away the computation of `value`.
+ */
+template <typename T>
+void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Wall time of one call of `fn`, in seconds.
+ */
+template <typename Fn>
+double wall_time(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+/**
+ * Run `fn` `reps` times and return the fastest wall time, in seconds.
+ */
+template <typename Fn>
+double best_of(int reps, Fn&& fn)
+{
+    double best = 0;
+    for (int i = 0; i < reps; ++i) {
+        const double seconds = wall_time(fn);
+        if (i == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+/**
+ * Print the time taken and throughput of a benchmark.
+ */
+inline void report(const char* name, double seconds, std::size_t bytes)
+{
+    printf("%-32s %10.2f ms %10.1f MB/s\n", name, seconds * 1e3, bytes / seconds / 1e6);
+}
+
+/**
+ * Print the time taken and rate of a benchmark that processes `n` items.
+ */
+inline void report_rate(const char* name, double seconds, std::size_t n, const char* unit)
+{
+    printf("%-32s %10.2f ms %10.2f M%s/s\n", name, seconds * 1e3, n / seconds / 1e6, unit);
+}
+
+/**
+ * Summary of the wall times of repeated runs, in seconds.
+ */
+struct Stats {
+    double min = 0;
+    double median = 0;
+    double p99 = 0;
+};
+
+inline Stats summarize(std::vector<double> samples)
+{
+    Stats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const std::size_t n = samples.size();
+    stats.min = samples[0];
+    stats.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    // nearest-rank percentile
+    stats.p99 = samples[static_cast<std::size_t>(std::ceil(0.99 * n)) - 1];
+    return stats;
+}
+
+}  // namespace aoc::bench
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * 2D grid of bits, e.g. the cells of a grid of characters that hold one
+ * letter. Each row is packed into 64-bit words, where bit `x % 64` of word
+ * `x / 64` is cell (x, y), so a word covers 64 cells of a row and shifting it
+ * moves them horizontally.
+ *
+ * Each row is surrounded by a word of zeros on either side, so that
+ * `shifted()` can read the neighbouring words without bounds checks. Cells
+ * past the last column are always zero.
+ *
+ * The buffer is allocated from a `std::pmr` memory resource, such as an arena.
+ */
+class BitGrid
+{
+public:
+    explicit BitGrid(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : words(resource) {}
+
+    /**
+     * Change the shape of the grid, and clear all cells. The buffer is reused
+     * if it is large enough.
+     */
+    void reset(int nrows, int ncols)
+    {
+        assert(nrows >= 0 && ncols >= 0);
+        nrows_ = nrows;
+        ncols_ = ncols;
+        words_per_row_ = (ncols + 63) / 64;
+        stride = words_per_row_ + 2;
+        words.assign(nrows * stride, 0);
+    }
+
+    int nrows() const { return nrows_; }
+    int ncols() const { return ncols_; }
+
+    /**
+     * Number of words that hold the cells of a row.
+     */
+    int words_per_row() const { return words_per_row_; }
+
+    bool test(int x, int y) const { return (row(y)[x / 64] >> (x % 64)) & 1; }
+
+    void set(int x, int y)
+    {
+        assert(x >= 0 && x < ncols_);
+        row(y)[x / 64] |= uint64_t(1) << (x % 64);
+    }
+
+    /**
+     * Words of row `y`. Bits past the last column must stay zero.
+     */
+    std::span<uint64_t> row(int y)
+    {
+        assert(y >= 0 && y < nrows_);
+        return std::span<uint64_t>(words.data() + y * stride + 1, words_per_row_);
+    }
+
+    std::span<const uint64_t> row(int y) const
+    {
+        assert(y >= 0 && y < nrows_);
+        return std::span<const uint64_t>(words.data() + y * stride + 1, words_per_row_);
+    }
+
+    /**
+     * The 64 cells of row `y` starting at column `64 * w + dx`, for `-64 <= dx
+     * <= 64`. Cells outside the grid read as zero. Bit `i` of the result is
+     * cell (64 * w + dx + i, y), so ANDing words shifted by different `dx`
+     * lines up cells that are `dx` columns apart.
+     */
+    uint64_t shifted(int y, int w, int dx) const
+    {
+        assert(y >= 0 && y < nrows_ && w >= 0 && w < words_per_row_ && dx >= -64 && dx <= 64);
+        // funnel shift of the two words that the cells span
+        const uint64_t* p = words.data() + y * stride + w + (dx >= 0 ? 1 : 0);
+        const unsigned __int128 pair = (static_cast<unsigned __int128>(p[1]) << 64) | p[0];
+        return static_cast<uint64_t>(pair >> (dx >= 0 ? dx : 64 + dx));
+    }
+
+private:
+    int nrows_ = 0;
+    int ncols_ = 0;
+    int words_per_row_ = 0;
+    std::ptrdiff_t stride = 0;  // words per row, with the padding
+    std::pmr::vector<uint64_t> words;
+};
+
+}  // namespace aoc
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * Square matrix of bits, e.g. the adjacency matrix of a relation over the
+ * integers 0, 1, ..., n-1. Each row is packed into 64-bit words.
+ */
+class BitMatrix
+{
+public:
+    explicit BitMatrix(int n) : n(n), words_per_row((n + 63) / 64), words(n * words_per_row, 0) {}
+
+    int size() const { return n; }
+
+    bool test(int i, int j) const
+    {
+        assert(i >= 0 && i < n && j >= 0 && j < n);
+        return (words[i * words_per_row + j / 64] >> (j % 64)) & 1;
+    }
+
+    void set(int i, int j)
+    {
+        assert(i >= 0 && i < n && j >= 0 && j < n);
+        words[i * words_per_row + j / 64] |= uint64_t(1) << (j % 64);
+    }
+
+    void reset(int i, int j)
+    {
+        assert(i >= 0 && i < n && j >= 0 && j < n);
+        words[i * words_per_row + j / 64] &= ~(uint64_t(1) << (j % 64));
+    }
+
+    /**
+     * Words of row `i`. Bit `j % 64` of word `j / 64` is entry (i, j).
+     */
+    std::span<const uint64_t> row(int i) const
+    {
+        return std::span<const uint64_t>(words.data() + i * words_per_row, words_per_row);
+    }
+
+private:
+    int n;
+    int words_per_row;
+    std::vector<uint64_t> words;
+};
+
+}  // namespace aoc
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+
+#include "bitgrid.h"
+#include "io.h"
+#include "literal.h"
+#include "simd.h"
+
+namespace aoc
+{
+
+/**
+ * Bit `i` is set iff byte `i` of `chunk` is `c`, for the 8 bytes of a chunk
+ * loaded from memory on a little-endian machine.
+ */
+inline uint8_t bytes_equal(uint64_t chunk, char c)
+{
+    constexpr uint64_t LOW_BITS = 0x7f7f7f7f7f7f7f7f;
+    const uint64_t x = chunk ^ (0x0101010101010101 * static_cast<uint8_t>(c));
+    // the high bit of each byte is set iff the byte of `x` is zero. unlike
+    // the usual `(x - 0x01..) & ~x & 0x80..`, no borrow crosses bytes.
+    const uint64_t zero = ~(((x & LOW_BITS) + LOW_BITS) | x) & ~LOW_BITS;
+    // gather the high bits into the top byte, which has no carries
+    return ((zero >> 7) * 0x0102040810204080) >> 56;
+}
+
+/**
+ * Grid of characters from a small alphabet `A`, e.g. "XMAS", as one bitplane
+ * per letter, where bit (x, y) of a plane is set iff cell (x, y) holds that
+ * letter. Other characters are in no plane. This takes `A.size()` bits per
+ * cell instead of a byte.
+ *
+ * Searching is then done 64 cells at a time: a letter `k` steps away in
+ * direction (dx, dy) is a word of the plane of row `y + k * dy` shifted by
+ * `k * dx` columns, and ANDing these gives the cells where a match starts.
+ * Cells outside the grid are zero in every plane, so matches cannot run off
+ * the edges.
+ */
+template <Literal A>
+class LetterPlanes
+{
+public:
+    explicit LetterPlanes(std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : LetterPlanes(resource)
+    {
+        read(text);
+    }
+
+    /**
+     * Empty grid, whose planes are allocated from `resource` when read.
+     */
+    explicit LetterPlanes(std::pmr::memory_resource* resource)
+        : planes([&]<std::size_t... I>(std::index_sequence<I...>) {
+              return std::array<BitGrid, A.size()>{((void)I, BitGrid(resource))...};
+          }(std::make_index_sequence<A.size()>()))
+    {
+    }
+
+    /**
+     * Replace the grid with the one in `text`, one row per line, reusing the
+     * planes' memory. All lines must have the same length.
+     */
+    void read(std::string_view text)
+    {
+        const Lines lines(text);
+        const int nrows = lines.count();
+        const int ncols = nrows > 0 ? lines.begin()->size() : 0;
+        for (auto& plane : planes) {
+            plane.reset(nrows, ncols);
+        }
+
+        int y = 0;
+        for (const auto line : lines) {
+            assert(line.size() == ncols);
+            for (int w = 0; w * 64 < ncols; ++w) {
+                const char* p = line.data() + w * 64;
+                const int n = std::min(64, ncols - w * 64);
+                std::array<uint64_t, A.size()> bits = {};
+
+                // 8 cells at a time, then one at a time
+                int i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    uint64_t chunk;
+                    std::memcpy(&chunk, p + i, 8);
+                    unroll<A>([&](auto k) { bits[k] |= uint64_t(bytes_equal(chunk, A[k])) << i; });
+                }
+                for (; i < n; ++i) {
+                    unroll<A>([&](auto k) { bits[k] |= uint64_t(p[i] == A[k]) << i; });
+                }
+
+                for (std::size_t k = 0; k < A.size(); ++k) {
+                    planes[k].row(y)[w] = bits[k];
+                }
+            }
+            ++y;
+        }
+    }
+
+    int nrows() const { return planes[0].nrows(); }
+    int ncols() const { return planes[0].ncols(); }
+
+    /**
+     * Plane of the cells that hold `letter`, which must be in the alphabet.
+     */
+    template <char letter>
+    const BitGrid& plane() const
+    {
+        constexpr std::size_t k = [] {
+            std::size_t i = 0;
+            while (i < A.size() && A[i] != letter) {
+                ++i;
+            }
+            return i;
+        }();
+        static_assert(k < A.size(), "letter is not in the alphabet");
+        return planes[k];
+    }
+
+    /**
+     * Bytes taken by the planes, including the padding of their rows.
+     */
+    std::size_t num_bytes() const
+    {
+        return A.size() * static_cast<std::size_t>(nrows()) * (planes[0].words_per_row() + 2) * sizeof(uint64_t);
+    }
+
+private:
+    std::array<BitGrid, A.size()> planes;
+};
+
+/**
+ * Count `W` starting in row `y` in direction (dx, dy), 64 cells at a time.
+ */
+template <Literal W, int dx, int dy, Literal A>
+int count_word_direction(const LetterPlanes<A>& grid, int y)
+{
+    // the word must also end inside the grid
+    const int y_last = y + static_cast<int>(W.size() - 1) * dy;
+    if (y_last < 0 || y_last >= grid.nrows()) {
+        return 0;
+    }
+
+    int count = 0;
+    const int words_per_row = (grid.ncols() + 63) / 64;
+    for (int w = 0; w < words_per_row; ++w) {
+        uint64_t match = ~uint64_t(0);
+        unroll<W>([&](auto k) {
+            constexpr int steps = k;
+            match &= grid.template plane<W[k]>().shifted(y + steps * dy, w, steps * dx);
+        });
+        count += __builtin_popcountll(match);
+    }
+    return count;
+}
+
+/**
+ * Count the number of times `W` appears in any of the 8 directions, 64 cells
+ * at a time. All directions are searched from a row before moving on to the
+ * next, so that the few rows they read stay in cache, and each direction is
+ * specialized so that its shifts are constants.
+ */
+template <Literal W, Literal A>
+int count_word_generic(const LetterPlanes<A>& grid)
+{
+    static constexpr int DIRECTIONS[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+    int count = 0;
+    for (int y = 0; y < grid.nrows(); ++y) {
+        count += [&]<std::size_t... D>(std::index_sequence<D...>) {
+            return (count_word_direction<W, DIRECTIONS[D][0], DIRECTIONS[D][1]>(grid, y) + ...);
+        }(std::make_index_sequence<8>());
+    }
+    return count;
+}
+
+/**
+ * Count the number of times the 3-letter word `W` appears twice in the shape
+ * of an X, e.g. "MAS", forwards or backwards along either diagonal, 64 centers
+ * at a time.
+ */
+template <Literal W, Literal A>
+int count_cross_generic(const LetterPlanes<A>& grid)
+{
+    static_assert(W.size() == 3, "a cross is of a 3-letter word");
+    const BitGrid& first = grid.template plane<W[0]>();
+    const BitGrid& center = grid.template plane<W[1]>();
+    const BitGrid& last = grid.template plane<W[2]>();
+
+    int count = 0;
+    for (int y = 1; y < grid.nrows() - 1; ++y) {
+        for (int w = 0; w < center.words_per_row(); ++w) {
+            // opposite corners must be one end of the word each
+            const uint64_t diagonal1 = (first.shifted(y - 1, w, -1) & last.shifted(y + 1, w, 1)) |
+                                       (last.shifted(y - 1, w, -1) & first.shifted(y + 1, w, 1));
+            const uint64_t diagonal2 = (first.shifted(y - 1, w, 1) & last.shifted(y + 1, w, -1)) |
+                                       (last.shifted(y - 1, w, 1) & first.shifted(y + 1, w, -1));
+            count += __builtin_popcountll(center.row(y)[w] & diagonal1 & diagonal2);
+        }
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+
+// sse4.2 comes with the popcnt instruction, which is otherwise a library call
+template <Literal W, Literal A>
+__attribute__((target("sse4.2"), flatten)) int count_word_sse42(const LetterPlanes<A>& grid)
+{
+    return count_word_generic<W>(grid);
+}
+
+template <Literal W, Literal A>
+__attribute__((target("sse4.2"), flatten)) int count_cross_sse42(const LetterPlanes<A>& grid)
+{
+    return count_cross_generic<W>(grid);
+}
+
+#endif
+
+template <Literal W, Literal A>
+int count_word(const LetterPlanes<A>& grid, simd::Level level = simd::best_level())
+{
+#if defined(__x86_64__)
+    if (level >= simd::Level::sse42) {
+        return count_word_sse42<W>(grid);
+    }
+#endif
+    return count_word_generic<W>(grid);
+}
+
+template <Literal W, Literal A>
+int count_cross(const LetterPlanes<A>& grid, simd::Level level = simd::best_level())
+{
+#if defined(__x86_64__)
+    if (level >= simd::Level::sse42) {
+        return count_cross_sse42<W>(grid);
+    }
+#endif
+    return count_cross_generic<W>(grid);
+}
+
+}  // namespace aoc
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "ragged.h"
+#include "simd.h"
+
+namespace aoc
+{
+
+namespace detail
+{
+
+/**
+ * Bitmasks over a 32-byte block of text. Bit i corresponds to byte i.
+ */
+struct BlockMasks {
+    uint32_t digits;
+    uint32_t newlines;
+};
+
+struct ScalarClassifier {
+    static BlockMasks classify(const char* p)
+    {
+        BlockMasks m = {0, 0};
+        for (int i = 0; i < 32; ++i) {
+            m.digits |= static_cast<uint32_t>(p[i] >= '0' && p[i] <= '9') << i;
+            m.newlines |= static_cast<uint32_t>(p[i] == '\n') << i;
+        }
+        return m;
+    }
+};
+
+/**
+ * Classifier using vectors of bytes `V` from simd.h.
+ */
+template <typename V>
+struct SimdClassifier {
+    static BlockMasks classify(const char* p)
+    {
+        BlockMasks m = {0, 0};
+        for (int i = 0; i < 32; i += V::WIDTH) {
+            const auto v = V::load(p + i);
+            const auto digits = V::bit_and(V::gt(v, V::splat('0' - 1)), V::gt(V::splat('9' + 1), v));
+            m.digits |= V::mask(digits) << i;
+            m.newlines |= V::mask(V::eq(v, V::splat('\n'))) << i;
+        }
+        return m;
+    }
+};
+
+/**
+ * Scan `text` for integers, 32 bytes at a time. For each integer
+ * `sink.value(n)` is called. For each line `sink.end_row(num_values)` is
+ * called, where `num_values` is the number of integers up to the end of the
+ * line; calls may be delayed until the end of the block.
+ * Any byte that is not a digit or '\n' is treated as a separator, except that
+ * a '-' directly before a digit negates the integer.
+ */
+template <typename Classifier, typename Sink>
+void scan_ints(std::string_view text, Sink& sink)
+{
+    constexpr std::size_t BLOCK = 32;
+    const char* data = text.data();
+    const std::size_t size = text.size();
+
+    auto decode = [&](std::size_t begin, std::size_t end) {
+        const std::size_t len = end - begin;
+        assert(len <= 9);  // fits in an int
+        int value = 0;
+        if (len <= 8 && end >= 8) {
+            // decode the (up to) 8 bytes before `end` at once, with the bytes
+            // before `begin` zeroed as leading zeros
+            uint64_t x;
+            std::memcpy(&x, data + end - 8, 8);
+            x &= 0x0F0F0F0F0F0F0F0F & (~uint64_t(0) << (8 * (8 - len)));
+            x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FF;
+            x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFF;
+            x = (x * 10000 + (x >> 32)) & 0xFFFFFFFF;
+            value = static_cast<int>(x);
+        } else {
+            for (std::size_t i = begin; i < end; ++i) {
+                value = value * 10 + (data[i] - '0');
+            }
+        }
+        if (begin > 0 && data[begin - 1] == '-') {
+            value = -value;
+        }
+        sink.value(value);
+    };
+
+    uint32_t prev_digit = 0;        // whether last byte of previous block was a digit
+    std::size_t number_start = 0;  // start of the integer continuing from the previous block
+    std::size_t num_values = 0;
+
+    for (std::size_t block = 0; block < size; block += BLOCK) {
+        BlockMasks m;
+        if (block + BLOCK <= size) {
+            m = Classifier::classify(data + block);
+        } else {
+            // pad the last block with separators
+            char tail[BLOCK];
+            std::memset(tail, ' ', BLOCK);
+            std::memcpy(tail, data + block, size - block);
+            m = Classifier::classify(tail);
+        }
+
+        // bit i of `follows_digit` is set if byte i-1 is a digit
+        const uint32_t follows_digit = (m.digits << 1) | prev_digit;
+        uint32_t starts = m.digits & ~follows_digit;
+        uint32_t ends = ~m.digits & follows_digit;
+        const std::size_t num_values_before = num_values;
+        num_values += __builtin_popcount(ends);
+
+        // first, the integer continuing from the previous block
+        if (prev_digit && ends) {
+            decode(number_start, block + __builtin_ctz(ends));
+            ends &= ends - 1;
+        }
+
+        // then every other integer that ends in this block, whose start is
+        // always the next start
+        while (ends) {
+            decode(block + __builtin_ctz(starts), block + __builtin_ctz(ends));
+            starts &= starts - 1;
+            ends &= ends - 1;
+        }
+
+        // the ends of lines, each of which comes after all integers ending
+        // at or before it
+        uint32_t newlines = m.newlines;
+        const uint32_t all_ends = ~m.digits & follows_digit;
+        while (newlines) {
+            const uint32_t upto = (newlines ^ (newlines - 1));  // bits up to and including the newline
+            sink.end_row(num_values_before + __builtin_popcount(all_ends & upto));
+            newlines &= newlines - 1;
+        }
+
+        // integer continues into the next block
+        if (starts) {
+            number_start = block + __builtin_ctz(starts);
+        }
+        prev_digit = m.digits >> 31;
+    }
+
+    if (prev_digit) {
+        decode(number_start, size);
+        ++num_values;
+    }
+    if (size > 0 && data[size - 1] != '\n') {
+        sink.end_row(num_values);
+    }
+}
+
+#if defined(__x86_64__)
+
+template <typename Sink>
+__attribute__((target("sse4.2"), flatten)) void scan_ints_sse42(std::string_view text, Sink& sink)
+{
+    scan_ints<SimdClassifier<simd::Sse42Bytes>>(text, sink);
+}
+
+template <typename Sink>
+__attribute__((target("avx2"), flatten)) void scan_ints_avx2(std::string_view text, Sink& sink)
+{
+    scan_ints<SimdClassifier<simd::Avx2Bytes>>(text, sink);
+}
+
+#endif
+
+template <typename Sink>
+void scan_ints(std::string_view text, Sink& sink, simd::Level level)
+{
+    switch (level) {
+#if defined(__x86_64__)
+        case simd::Level::avx2:
+            scan_ints_avx2(text, sink);
+            return;
+        case simd::Level::sse42:
+            scan_ints_sse42(text, sink);
+            return;
+#endif
+        default:
+            scan_ints<ScalarClassifier>(text, sink);
+            return;
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Parse a text file where each line contains `N` whitespace-separated
+ * integers into `N` columns. The columns can be any vectors of `int`, e.g.
+ * `std::pmr::vector<int>`, and keep their allocators.
+ */
+template <std::size_t N, typename Vector>
+void parse_columns(std::string_view text, std::array<Vector, N>& columns, simd::Level level = simd::best_level())
+{
+    // size the columns up front, so that the values can be written in place
+    const std::size_t max_rows = std::count(text.begin(), text.end(), '\n') + 1;
+    for (auto& column : columns) {
+        column.resize(max_rows);
+    }
+
+    struct Sink {
+        std::array<int*, N> columns;
+        std::size_t row = 0;
+        std::size_t col = 0;
+        std::size_t num_rows = 0;
+
+        void value(int n)
+        {
+            columns[col][row] = n;
+            if (++col == N) {
+                col = 0;
+                ++row;
+            }
+        }
+
+        void end_row(std::size_t num_values)
+        {
+            assert(num_values == N * (num_rows + 1));  // each row has `N` integers
+            ++num_rows;
+        }
+    } sink;
+
+    for (std::size_t i = 0; i < N; ++i) {
+        sink.columns[i] = columns[i].data();
+    }
+    detail::scan_ints(text, sink, level);
+
+    for (auto& column : columns) {
+        column.resize(sink.num_rows);
+    }
+}
+
+/**
+ * Parse a text file where each line contains `N` whitespace-separated
+ * integers into `N` columns.
+ */
+template <std::size_t N>
+std::array<std::vector<int>, N> parse_columns(std::string_view text, simd::Level level = simd::best_level())
+{
+    std::array<std::vector<int>, N> columns;
+    parse_columns(text, columns, level);
+    return columns;
+}
+
+/**
+ * Parse a text file where each line contains a row of whitespace-separated
+ * integers into `rows`, replacing its contents.
+ */
+inline void parse_rows(std::string_view text, Ragged<int>& rows, simd::Level level = simd::best_level())
+{
+    struct Sink {
+        Ragged<int>& rows;
+
+        void value(int n) { rows.push_back(n); }
+        void end_row(std::size_t num_values) { rows.end_row(num_values); }
+    } sink{rows};
+
+    // every integer takes at least two bytes, including its separator. this
+    // only reserves address space; pages are not touched until written.
+    const std::size_t max_rows = std::count(text.begin(), text.end(), '\n') + 1;
+    rows.clear();
+    rows.reserve(max_rows, text.size() / 2 + 1);
+    detail::scan_ints(text, sink, level);
+}
+
+/**
+ * Parse a text file where each line contains a row of whitespace-separated
+ * integers.
+ */
+inline Ragged<int> parse_rows(std::string_view text, simd::Level level = simd::best_level())
+{
+    Ragged<int> rows;
+    parse_rows(text, rows, level);
+    return rows;
+}
+
+}  // namespace aoc
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "sort.h"
+
+namespace aoc
+{
+
+/**
+ * Memory that streaming solutions may use for buffered data, in bytes. Set by
+ * the `--memory` flag.
+ */
+inline std::size_t& memory_budget()
+{
+    static std::size_t budget = std::size_t(256) << 20;
+    return budget;
+}
+
+inline void set_memory_budget(std::size_t budget)
+{
+    assert(budget > 0);
+    memory_budget() = budget;
+}
+
+/**
+ * Sorts a stream of integers that may not fit in memory.
+ *
+ * Values are buffered until the buffer reaches the memory budget. A full
+ * buffer is sorted and spilled to a temporary file as a run, and the runs are
+ * merged when the values are read back in order. Values that fit in the budget
+ * are never written out, so this is an in-memory sort for small inputs.
+ */
+class ExternalSorter
+{
+public:
+    /**
+     * Sorted values, read back one at a time by a k-way merge of the runs.
+     * Each run has a buffer of its own, and together they fit in the budget.
+     */
+    class Reader
+    {
+    public:
+        /**
+         * Get the next value in ascending order.
+         * @returns False if all values have been read
+         */
+        bool next(int& value)
+        {
+            if (heap.empty()) {
+                return false;
+            }
+            const auto [min, i] = heap.top();
+            heap.pop();
+            value = min;
+
+            Run& run = runs[i];
+            if (++run.pos == run.block.size()) {
+                refill(run);
+            }
+            if (run.pos < run.block.size()) {
+                heap.emplace(run.block[run.pos], i);
+            }
+            return true;
+        }
+
+    private:
+        friend class ExternalSorter;
+
+        struct Run {
+            off_t offset = 0;          // in the spill file, of the values not yet in `block`
+            std::size_t remaining = 0;  // values in the spill file not yet in `block`
+            std::vector<int> block;
+            std::size_t pos = 0;
+        };
+
+        Reader(int fd, std::vector<Run> runs, std::size_t block_size)
+            : fd(fd), runs(std::move(runs)), block_size(block_size)
+        {
+            for (std::size_t i = 0; i < this->runs.size(); ++i) {
+                Run& run = this->runs[i];
+                if (run.block.empty()) {
+                    refill(run);
+                }
+                if (!run.block.empty()) {
+                    heap.emplace(run.block[0], i);
+                }
+            }
+        }
+
+        void refill(Run& run)
+        {
+            const std::size_t n = std::min(run.remaining, block_size);
+            run.block.resize(n);
+            run.pos = 0;
+            if (n > 0) {
+                const ssize_t bytes = pread(fd, run.block.data(), n * sizeof(int), run.offset);
+                assert(bytes == static_cast<ssize_t>(n * sizeof(int)));
+                run.offset += bytes;
+                run.remaining -= n;
+            }
+        }
+
+        int fd;
+        std::vector<Run> runs;
+        std::size_t block_size;
+        std::priority_queue<std::pair<int, std::size_t>,
+                            std::vector<std::pair<int, std::size_t>>,
+                            std::greater<std::pair<int, std::size_t>>>
+            heap;  // next value of each run that has values left, and the run
+    };
+
+    explicit ExternalSorter(std::size_t budget = memory_budget())
+        : capacity(std::max<std::size_t>(budget / sizeof(int), MIN_CAPACITY)), budget(budget)
+    {
+    }
+
+    ~ExternalSorter()
+    {
+        if (spill_file) {
+            std::fclose(spill_file);
+        }
+    }
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    void push(int value)
+    {
+        buffer.push_back(value);
+        if (buffer.size() == capacity) {
+            spill();
+        }
+    }
+
+    /**
+     * Number of values pushed.
+     */
+    std::size_t size() const { return num_spilled + buffer.size(); }
+
+    /**
+     * Number of runs spilled to the temporary file.
+     */
+    std::size_t num_runs() const { return spilled_runs.size(); }
+
+    /**
+     * Read the values back in sorted order. No values may be pushed after
+     * this, and only one reader may be made.
+     */
+    Reader sorted()
+    {
+        sort_ints(buffer);
+
+        std::vector<Reader::Run> runs(spilled_runs.size() + 1);
+        for (std::size_t i = 0; i < spilled_runs.size(); ++i) {
+            runs[i].offset = spilled_runs[i].first;
+            runs[i].remaining = spilled_runs[i].second;
+        }
+        // the values still in memory are the last run
+        runs.back().block = std::move(buffer);
+
+        // share the budget between the blocks of the spilled runs
+        const std::size_t block_size =
+            std::max<std::size_t>(budget / sizeof(int) / std::max<std::size_t>(spilled_runs.size(), 1), MIN_BLOCK);
+        return Reader(spill_file ? fileno(spill_file) : -1, std::move(runs), block_size);
+    }
+
+private:
+    static constexpr std::size_t MIN_CAPACITY = 1 << 10;
+    static constexpr std::size_t MIN_BLOCK = 1 << 10;
+
+    /**
+     * Sort the buffer and append it to the spill file as a run.
+     */
+    void spill()
+    {
+        if (!spill_file) {
+            spill_file = std::tmpfile();  // deleted when closed
+            assert(spill_file != nullptr);
+        }
+        sort_ints(buffer);
+
+        const off_t offset = static_cast<off_t>(num_spilled * sizeof(int));
+        const ssize_t bytes = pwrite(fileno(spill_file), buffer.data(), buffer.size() * sizeof(int), offset);
+        assert(bytes == static_cast<ssize_t>(buffer.size() * sizeof(int)));
+        spilled_runs.emplace_back(offset, buffer.size());
+        num_spilled += buffer.size();
+        buffer.clear();
+    }
+
+    std::size_t capacity;  // values buffered before a spill
+    std::size_t budget;
+    std::vector<int> buffer;
+
+    std::FILE* spill_file = nullptr;
+    std::vector<std::pair<off_t, std::size_t>> spilled_runs;  // offset and number of values of each run
+    std::size_t num_spilled = 0;
+};
+
+}  // namespace aoc
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * Counts occurrences of integer keys in a flat array, with one probe per
+ * insert and lookup.
+ *
+ * A dense counter holds keys in a fixed range `[min, max]`, with one count per
+ * key in the range. Otherwise, keys are stored in an open-addressing hash
+ * table with linear probing that grows as needed. Use `count` or
+ * `count_sorted` to choose between the two from the keys themselves.
+ */
+class FlatCounter
+{
+public:
+    /**
+     * Empty hash table counter, for any keys.
+     */
+    FlatCounter() : slots(MIN_CAPACITY) {}
+
+    /**
+     * Empty dense counter, for keys in `[min, max]`.
+     */
+    FlatCounter(int min, int max) : dense(true), min(min)
+    {
+        assert(min <= max);
+        counts.assign(static_cast<std::size_t>(static_cast<int64_t>(max) - min + 1), 0);
+    }
+
+    /**
+     * Count the given keys, in a dense counter if their range is not much
+     * larger than their number.
+     */
+    static FlatCounter count(std::span<const int> keys)
+    {
+        FlatCounter counter = make(keys, keys.size());
+        for (const int key : keys) {
+            counter.add(key);
+        }
+        return counter;
+    }
+
+    /**
+     * Count the given keys, which must be sorted. Each run of equal keys is
+     * inserted once.
+     */
+    static FlatCounter count_sorted(std::span<const int> keys)
+    {
+        assert(std::is_sorted(keys.begin(), keys.end()));
+        std::size_t num_distinct = 0;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            num_distinct += i == 0 || keys[i] != keys[i - 1];
+        }
+
+        FlatCounter counter = make(keys, num_distinct);
+        for (std::size_t i = 0; i < keys.size();) {
+            std::size_t j = i + 1;
+            while (j < keys.size() && keys[j] == keys[i]) {
+                ++j;
+            }
+            counter.add(keys[i], j - i);
+            i = j;
+        }
+        return counter;
+    }
+
+    bool is_dense() const { return dense; }
+
+    /**
+     * Number of distinct keys of a hash table counter.
+     */
+    std::size_t num_keys() const
+    {
+        assert(!dense);
+        return size;
+    }
+
+    /**
+     * Add `n` occurrences of `key`.
+     */
+    void add(int key, uint32_t n = 1)
+    {
+        if (dense) {
+            assert(key >= min && static_cast<std::size_t>(static_cast<int64_t>(key) - min) < counts.size());
+            counts[static_cast<int64_t>(key) - min] += n;
+            return;
+        }
+
+        assert(n > 0);
+        Slot& slot = slots[find(key)];
+        if (slot.count == 0) {
+            slot.key = key;
+            ++size;
+            if (2 * size > slots.size()) {
+                slot.count = n;
+                grow();
+                return;
+            }
+        }
+        slot.count += n;
+    }
+
+    /**
+     * Number of occurrences of `key`.
+     */
+    uint32_t operator[](int key) const
+    {
+        if (dense) {
+            const int64_t i = static_cast<int64_t>(key) - min;
+            return i >= 0 && i < static_cast<int64_t>(counts.size()) ? counts[i] : 0;
+        }
+        return slots[find(key)].count;
+    }
+
+    /**
+     * Call `fn(key, count)` for every key that occurs, in no particular order.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        if (dense) {
+            for (std::size_t i = 0; i < counts.size(); ++i) {
+                if (counts[i] != 0) {
+                    fn(static_cast<int>(min + static_cast<int64_t>(i)), counts[i]);
+                }
+            }
+            return;
+        }
+        for (const Slot& slot : slots) {
+            if (slot.count != 0) {
+                fn(slot.key, slot.count);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        int key = 0;
+        uint32_t count = 0;  // 0 if the slot is empty
+    };
+
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    /**
+     * Counter for the given keys, dense if their range is at most four times
+     * `num_distinct`, and otherwise a hash table sized for `num_distinct` keys.
+     */
+    static FlatCounter make(std::span<const int> keys, std::size_t num_distinct)
+    {
+        if (!keys.empty()) {
+            const auto [min_it, max_it] = std::minmax_element(keys.begin(), keys.end());
+            const int64_t range = static_cast<int64_t>(*max_it) - *min_it + 1;
+            if (range <= static_cast<int64_t>(std::max<std::size_t>(4 * num_distinct, 1 << 10))) {
+                return FlatCounter(*min_it, *max_it);
+            }
+        }
+
+        FlatCounter counter;
+        std::size_t capacity = MIN_CAPACITY;
+        while (capacity < 2 * num_distinct) {
+            capacity *= 2;
+        }
+        counter.slots.resize(capacity);
+        return counter;
+    }
+
+    /**
+     * Index of the slot holding `key`, or of the empty slot where it would be
+     * inserted.
+     */
+    std::size_t find(int key) const
+    {
+        const std::size_t mask = slots.size() - 1;
+        // Fibonacci hashing: the high bits of the product are well mixed
+        std::size_t i = (static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (slots[i].count != 0 && slots[i].key != key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    /**
+     * Double the capacity of the hash table, and reinsert all keys.
+     */
+    void grow()
+    {
+        std::vector<Slot> old_slots(2 * slots.size());
+        old_slots.swap(slots);
+        for (const Slot& slot : old_slots) {
+            if (slot.count != 0) {
+                slots[find(slot.key)] = slot;
+            }
+        }
+    }
+
+    bool dense = false;
+
+    // dense counter
+    int min = 0;
+    std::vector<uint32_t> counts;
+
+    // hash table counter. the capacity is a power of 2, and at most half the
+    // slots are used
+    std::vector<Slot> slots;
+    std::size_t size = 0;
+};
+
+}  // namespace aoc
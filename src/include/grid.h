@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "io.h"
+
+namespace aoc
+{
+
+/**
+ * View of every `stride`-th element, e.g. a column or diagonal of a grid.
+ */
+template <typename T>
+class StridedView
+{
+public:
+    StridedView(T* first, std::ptrdiff_t stride, int size) : first(first), stride(stride), n(size) {}
+
+    T& operator[](int i) const { return first[i * stride]; }
+    int size() const { return n; }
+
+private:
+    T* first;
+    std::ptrdiff_t stride;
+    int n;
+};
+
+/**
+ * 2D grid stored in a single contiguous row-major buffer.
+ *
+ * The grid can be surrounded by a border of `padding` cells filled with a
+ * sentinel value, so that `at(x, y)` is valid for `-padding <= x < ncols +
+ * padding` and likewise for `y`. Searches that look at most `padding` cells
+ * away from a cell inside the grid then do not need bounds checks.
+ *
+ * The buffer is allocated from a `std::pmr` memory resource, such as an arena.
+ */
+template <typename T>
+class Grid
+{
+public:
+    Grid(int nrows,
+         int ncols,
+         int padding = 0,
+         T sentinel = T(),
+         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : cells(resource)
+    {
+        reset(nrows, ncols, padding, sentinel);
+    }
+
+    /**
+     * Empty grid.
+     */
+    explicit Grid(std::pmr::memory_resource* resource) : cells(resource) {}
+
+    /**
+     * Change the shape of the grid, and fill all cells with `sentinel`. The
+     * buffer is reused if it is large enough.
+     */
+    void reset(int nrows, int ncols, int padding = 0, T sentinel = T())
+    {
+        assert(nrows >= 0 && ncols >= 0 && padding >= 0);
+        nrows_ = nrows;
+        ncols_ = ncols;
+        padding_ = padding;
+        stride_ = ncols + 2 * padding;
+        cells.assign((nrows + 2 * padding) * stride_, sentinel);
+    }
+
+    int nrows() const { return nrows_; }
+    int ncols() const { return ncols_; }
+    int padding() const { return padding_; }
+
+    /**
+     * Distance between vertically adjacent cells in the buffer.
+     */
+    std::ptrdiff_t stride() const { return stride_; }
+
+    T& at(int x, int y) { return cells[index(x, y)]; }
+    const T& at(int x, int y) const { return cells[index(x, y)]; }
+
+    /**
+     * Pointer to cell (x, y). Neighbouring cells are at offsets of +-1 and
+     * +-`stride()`.
+     */
+    T* ptr(int x, int y) { return cells.data() + index(x, y); }
+    const T* ptr(int x, int y) const { return cells.data() + index(x, y); }
+
+    std::span<T> row(int y) { return std::span<T>(ptr(0, y), ncols_); }
+    std::span<const T> row(int y) const { return std::span<const T>(ptr(0, y), ncols_); }
+
+    StridedView<T> col(int x) { return StridedView<T>(ptr(x, 0), stride_, nrows_); }
+    StridedView<const T> col(int x) const { return StridedView<const T>(ptr(x, 0), stride_, nrows_); }
+
+    /**
+     * Diagonal going down and to the right from cell (x, y) on the top or
+     * left edge, i.e. x == 0 or y == 0.
+     */
+    StridedView<const T> diagonal(int x, int y) const
+    {
+        assert(x == 0 || y == 0);
+        return StridedView<const T>(ptr(x, y), stride_ + 1, std::min(ncols_ - x, nrows_ - y));
+    }
+
+    /**
+     * Diagonal going down and to the left from cell (x, y) on the top or
+     * right edge, i.e. x == ncols - 1 or y == 0.
+     */
+    StridedView<const T> antidiagonal(int x, int y) const
+    {
+        assert(x == ncols_ - 1 || y == 0);
+        return StridedView<const T>(ptr(x, y), stride_ - 1, std::min(x + 1, nrows_ - y));
+    }
+
+private:
+    int nrows_ = 0;
+    int ncols_ = 0;
+    int padding_ = 0;
+    std::ptrdiff_t stride_ = 0;
+    std::pmr::vector<T> cells;
+
+    std::ptrdiff_t index(int x, int y) const
+    {
+        assert(x >= -padding_ && x < ncols_ + padding_);
+        assert(y >= -padding_ && y < nrows_ + padding_);
+        return (y + padding_) * stride_ + (x + padding_);
+    }
+};
+
+/**
+ * Read a grid of characters from text into `grid`, one row per line. All lines
+ * must have the same length.
+ */
+inline void read_grid(std::string_view text, Grid<char>& grid, int padding = 0, char sentinel = '.')
+{
+    const Lines lines(text);
+    const int nrows = lines.count();
+    const int ncols = nrows > 0 ? lines.begin()->size() : 0;
+
+    grid.reset(nrows, ncols, padding, sentinel);
+    int y = 0;
+    for (const auto line : lines) {
+        assert(line.size() == ncols);
+        std::copy(line.begin(), line.end(), grid.ptr(0, y++));
+    }
+}
+
+/**
+ * Read a grid of characters from text, one row per line. All lines must have
+ * the same length.
+ */
+inline Grid<char> read_grid(std::string_view text, int padding = 0, char sentinel = '.')
+{
+    Grid<char> grid(std::pmr::get_default_resource());
+    read_grid(text, grid, padding, sentinel);
+    return grid;
+}
+
+}  // namespace aoc
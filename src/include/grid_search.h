@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "aho_corasick.h"
+#include "grid.h"
+
+namespace aoc
+{
+
+/**
+ * A match of a pattern in a grid, which is read starting at cell (x, y) in
+ * direction (dx, dy).
+ */
+struct GridMatch {
+    int pattern;
+    int x;
+    int y;
+    int dx;
+    int dy;
+};
+
+/**
+ * Call `fn(x, y, dx, dy, length)` for every maximal line through the grid in
+ * each of the 8 directions, i.e. every row, column and diagonal read both
+ * forwards and backwards. The line starts at cell (x, y).
+ */
+template <typename T, typename Fn>
+void for_each_grid_line(const Grid<T>& grid, Fn&& fn)
+{
+    static const int DIRECTIONS[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+    const int nrows = grid.nrows();
+    const int ncols = grid.ncols();
+
+    auto in_bounds = [&](int x, int y) { return x >= 0 && x < ncols && y >= 0 && y < nrows; };
+
+    // number of cells until we leave the grid
+    auto length = [&](int x, int y, int dx, int dy) {
+        const int nx = dx > 0 ? ncols - x : dx < 0 ? x + 1 : ncols + nrows;
+        const int ny = dy > 0 ? nrows - y : dy < 0 ? y + 1 : ncols + nrows;
+        return std::min(nx, ny);
+    };
+
+    // every line starts on the edge of the grid, at a cell whose predecessor
+    // in the line's direction is outside the grid
+    auto visit = [&](int x, int y) {
+        for (const auto& dir : DIRECTIONS) {
+            if (!in_bounds(x - dir[0], y - dir[1])) {
+                fn(x, y, dir[0], dir[1], length(x, y, dir[0], dir[1]));
+            }
+        }
+    };
+
+    for (int y = 0; y < nrows; ++y) {
+        if (y == 0 || y == nrows - 1) {
+            for (int x = 0; x < ncols; ++x) {
+                visit(x, y);
+            }
+        } else {
+            visit(0, y);
+            if (ncols > 1) {
+                visit(ncols - 1, y);
+            }
+        }
+    }
+}
+
+/**
+ * Count the matches of each pattern of the automaton in the grid, reading in
+ * all 8 directions. Runs in time linear in the size of the grid, regardless
+ * of the number of patterns.
+ */
+inline std::vector<long long> count_in_grid(const AhoCorasick& automaton, const Grid<char>& grid)
+{
+    std::vector<long long> visits(automaton.num_states(), 0);
+
+    for_each_grid_line(grid, [&](int x, int y, int dx, int dy, int length) {
+        const char* p = grid.ptr(x, y);
+        const std::ptrdiff_t step = dx + dy * grid.stride();
+        int state = 0;
+        for (int i = 0; i < length; ++i, p += step) {
+            state = automaton.next(state, *p);
+            ++visits[state];
+        }
+    });
+
+    return automaton.count_matches(visits);
+}
+
+/**
+ * Call `fn(match)` with a `GridMatch` for every match of a pattern of the
+ * automaton in the grid, reading in all 8 directions.
+ */
+template <typename Fn>
+void find_in_grid(const AhoCorasick& automaton, const Grid<char>& grid, Fn&& fn)
+{
+    for_each_grid_line(grid, [&](int x, int y, int dx, int dy, int length) {
+        const char* p = grid.ptr(x, y);
+        const std::ptrdiff_t step = dx + dy * grid.stride();
+        int state = 0;
+        for (int i = 0; i < length; ++i, p += step) {
+            state = automaton.next(state, *p);
+            automaton.for_each_match(state, [&](int pattern, int pattern_length) {
+                const int start = i - pattern_length + 1;
+                fn(GridMatch{pattern, x + start * dx, y + start * dy, dx, dy});
+            });
+        }
+    });
+}
+
+}  // namespace aoc
@@ -1,17 +1,280 @@
 #pragma once
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace aoc
 {
 
+/**
+ * Range over the lines of a block of text, as views into the text. Lines are
+ * split on '\n' with the same semantics as `getline`, i.e. a trailing newline
+ * does not produce an extra empty line.
+ */
+class Lines
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        iterator(const char* pos, const char* end) : pos(pos), end(end) { find_line(); }
+
+        reference operator*() const { return line; }
+        pointer operator->() const { return &line; }
+
+        iterator& operator++()
+        {
+            pos += line.size();
+            if (pos != end) {
+                ++pos;  // skip the '\n'
+            }
+            find_line();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+
+    private:
+        const char* pos = nullptr;
+        const char* end = nullptr;
+        std::string_view line;
+
+        void find_line()
+        {
+            const void* nl = pos != end ? std::memchr(pos, '\n', end - pos) : nullptr;
+            const char* line_end = nl ? static_cast<const char*>(nl) : end;
+            line = std::string_view(pos, line_end - pos);
+        }
+    };
+
+    explicit Lines(std::string_view text) : text(text) {}
+
+    iterator begin() const { return iterator(text.data(), text.data() + text.size()); }
+    iterator end() const
+    {
+        const char* end = text.data() + text.size();
+        return iterator(end, end);
+    }
+
+    /**
+     * Number of lines. This requires a scan over the text.
+     */
+    std::size_t count() const
+    {
+        if (text.empty()) {
+            return 0;
+        }
+        const std::size_t num_newlines = std::count(text.begin(), text.end(), '\n');
+        return text.back() == '\n' ? num_newlines : num_newlines + 1;
+    }
+
+private:
+    std::string_view text;
+};
+
+/**
+ * Read-only view of the contents of an input file. Regular files are
+ * memory-mapped, so no copy is made. Anything that cannot be mapped, e.g.
+ * stdin (given as "-") or a pipe, is read into a buffer instead.
+ */
+class Input
+{
+public:
+    explicit Input(const char* filename)
+    {
+        const bool is_stdin = std::strcmp(filename, "-") == 0;
+        const int fd = is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+        assert(fd != -1);
+
+        struct stat st;
+        const int err = fstat(fd, &st);
+        assert(err == 0);
+
+        if (S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            assert(addr != MAP_FAILED);
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            mapped = std::string_view(static_cast<const char*>(addr), st.st_size);
+        } else {
+            char block[1 << 16];
+            ssize_t n;
+            while ((n = read(fd, block, sizeof(block))) > 0) {
+                buffer.append(block, n);
+            }
+            assert(n == 0);
+        }
+
+        if (!is_stdin) {
+            close(fd);
+        }
+    }
+
+    ~Input()
+    {
+        if (!mapped.empty()) {
+            munmap(const_cast<char*>(mapped.data()), mapped.size());
+        }
+    }
+
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    /**
+     * Contents of the file.
+     */
+    std::string_view view() const { return mapped.empty() ? std::string_view(buffer) : mapped; }
+
+    /**
+     * Lines of the file.
+     */
+    Lines lines() const { return Lines(view()); }
+
+private:
+    std::string_view mapped;
+    std::string buffer;
+};
+
+/**
+ * Read a file in blocks of at most `block_size` bytes, calling `fn` with each
+ * block as a `std::string_view`. Unlike `Input`, memory use is bounded by the
+ * block size, and stdin (given as "-") or a pipe is streamed as well.
+ */
+template <typename Fn>
+void read_blocks(const char* filename, Fn&& fn, std::size_t block_size = 1 << 20)
+{
+    const bool is_stdin = std::strcmp(filename, "-") == 0;
+    const int fd = is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+    assert(fd != -1);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    std::vector<char> block(block_size);
+    ssize_t n;
+    while ((n = read(fd, block.data(), block.size())) > 0) {
+        fn(std::string_view(block.data(), n));
+    }
+    assert(n == 0);
+
+    if (!is_stdin) {
+        close(fd);
+    }
+}
+
+/**
+ * Read a file in blocks of whole lines, calling `fn` with each block as a
+ * `std::string_view`. A line is never split between blocks: the partial line
+ * at the end of a read is carried over to the next block. Blocks are about
+ * `block_size` bytes, or longer if a single line is.
+ */
+template <typename Fn>
+void read_line_blocks(const char* filename, Fn&& fn, std::size_t block_size = 1 << 20)
+{
+    std::string carry;
+    read_blocks(
+        filename,
+        [&](std::string_view block) {
+            const std::size_t last_newline = block.rfind('\n');
+            if (last_newline == std::string_view::npos) {
+                carry.append(block);
+                return;
+            }
+            if (carry.empty()) {
+                fn(block.substr(0, last_newline + 1));
+            } else {
+                carry.append(block.substr(0, last_newline + 1));
+                fn(std::string_view(carry));
+                carry.clear();
+            }
+            carry.append(block.substr(last_newline + 1));
+        },
+        block_size);
+    if (!carry.empty()) {
+        fn(std::string_view(carry));
+    }
+}
+
+/**
+ * Whether a file is read as a stream, i.e. it is stdin (given as "-") or
+ * something other than a regular file, such as a pipe. Its size is not known
+ * up front, and it can only be read once.
+ */
+inline bool is_stream(const char* filename)
+{
+    struct stat st;
+    return std::strcmp(filename, "-") == 0 || stat(filename, &st) != 0 || !S_ISREG(st.st_mode);
+}
+
+/**
+ * Parse a size in bytes with an optional suffix K, M or G, in powers of 1024.
+ * @param size Output. The size in bytes.
+ * @returns False if `str` is not a number with one of these suffixes
+ */
+inline bool parse_size(const char* str, std::size_t& size)
+{
+    char* end;
+    const double value = std::strtod(str, &end);
+    if (end == str || value < 0) {
+        return false;
+    }
+    std::size_t unit = 1;
+    switch (*end) {
+        case '\0':
+            break;
+        case 'K':
+        case 'k':
+            unit = 1ull << 10;
+            break;
+        case 'M':
+        case 'm':
+            unit = 1ull << 20;
+            break;
+        case 'G':
+        case 'g':
+            unit = 1ull << 30;
+            break;
+        default:
+            return false;
+    }
+    if (unit > 1 && end[1] != '\0') {
+        return false;
+    }
+    size = static_cast<std::size_t>(value * unit);
+    return true;
+}
+
 /**
  * Read lines from a text file.
+ * @note Prefer `Input`, which does not copy each line. This is kept for
+ * callers that want to own the lines.
  */
-std::vector<std::string> read_lines(const char* filename)
+inline std::vector<std::string> read_lines(const char* filename)
 {
     std::fstream f(filename);
     std::vector<std::string> lines;
@@ -28,14 +291,14 @@ std::vector<std::string> read_lines(const char* filename)
 /**
  * Split the string `str` using the separator `sep`.
  */
-std::vector<std::string> split(const std::string& str, const std::string& sep)
+inline std::vector<std::string> split(std::string_view str, std::string_view sep)
 {
     assert(sep.size() > 0);
     std::vector<std::string> parts;
 
-    std::string::size_type start = 0;
-    std::string::size_type end = str.find(sep, start);
-    while (end != std::string::npos) {
+    std::string_view::size_type start = 0;
+    std::string_view::size_type end = str.find(sep, start);
+    while (end != std::string_view::npos) {
         parts.emplace_back(str.substr(start, end - start));
         start = end + sep.size();
         end = str.find(sep, start);
@@ -45,10 +308,123 @@ std::vector<std::string> split(const std::string& str, const std::string& sep)
     return parts;
 }
 
+/**
+ * Lazy range over the parts of `str` separated by `sep`, as views into `str`.
+ * Yields the same parts as `split`, without allocating.
+ */
+class SplitView
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        iterator(std::string_view str, std::string_view sep, std::string_view::size_type start)
+            : str(str), sep(sep), start(start)
+        {
+            find_part();
+        }
+
+        reference operator*() const { return part; }
+        pointer operator->() const { return &part; }
+
+        iterator& operator++()
+        {
+            start += part.size();
+            start = start < str.size() ? start + sep.size() : std::string_view::npos;
+            find_part();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const iterator& other) const { return start == other.start; }
+
+    private:
+        std::string_view str;
+        std::string_view sep;
+        std::string_view::size_type start = std::string_view::npos;  // npos once past the last part
+        std::string_view part;
+
+        void find_part()
+        {
+            if (start != std::string_view::npos) {
+                const auto end = str.find(sep, start);
+                part = str.substr(start, end == std::string_view::npos ? end : end - start);
+            }
+        }
+    };
+
+    SplitView(std::string_view str, std::string_view sep) : str(str), sep(sep) { assert(sep.size() > 0); }
+
+    iterator begin() const { return iterator(str, sep, 0); }
+    iterator end() const { return iterator(str, sep, std::string_view::npos); }
+
+private:
+    std::string_view str;
+    std::string_view sep;
+};
+
+/**
+ * Split the string `str` using the separator `sep`, without allocating.
+ */
+inline SplitView split_view(std::string_view str, std::string_view sep)
+{
+    return SplitView(str, sep);
+}
+
+/**
+ * Parse an integer. The whole string must be consumed.
+ */
+inline int parse_int(std::string_view str)
+{
+    int value;
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    assert(ec == std::errc());
+    assert(ptr == str.data() + str.size());
+    return value;
+}
+
+/**
+ * Parse the integers in `str` separated by the character `sep` into `out`.
+ * Returns the number of integers parsed.
+ */
+inline std::size_t parse_ints(std::string_view str, char sep, std::span<int> out)
+{
+    const char* pos = str.data();
+    const char* end = str.data() + str.size();
+
+    std::size_t n = 0;
+    while (true) {
+        assert(n < out.size());
+        const auto [ptr, ec] = std::from_chars(pos, end, out[n]);
+        assert(ec == std::errc());
+        ++n;
+        if (ptr == end) {
+            break;
+        }
+        assert(*ptr == sep);
+        pos = ptr + 1;
+    }
+
+    return n;
+}
+
 /**
  * Convert vector of strings into vector of integers.
  */
-std::vector<int> stoi(const std::vector<std::string>& strs)
+inline std::vector<int> stoi(const std::vector<std::string>& strs)
 {
     std::vector<int> ints(strs.size());
     for (int i = 0; i < strs.size(); ++i) {
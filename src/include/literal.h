@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace aoc
+{
+
+/**
+ * String literal that can be a template argument, e.g. `match<"XMAS">(p)`.
+ * Matchers are then specialized for the literal at compile time: every
+ * comparison is unrolled and compares against a constant, with no loop over a
+ * runtime pattern and no tables.
+ */
+template <std::size_t N>
+struct Literal {
+    char chars[N - 1];
+
+    consteval Literal(const char (&str)[N])
+    {
+        static_assert(N > 1, "literal must not be empty");
+        for (std::size_t i = 0; i < N - 1; ++i) {
+            chars[i] = str[i];
+        }
+    }
+
+    static constexpr std::size_t size() { return N - 1; }
+
+    constexpr char operator[](std::size_t i) const { return chars[i]; }
+};
+
+/**
+ * Call `fn(std::integral_constant<std::size_t, I>())` for each index `I` of
+ * the literal, in order. The index is a constant expression in `fn`, so
+ * `L[I]` is too.
+ */
+template <Literal L, typename Fn>
+constexpr void unroll(Fn&& fn)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (fn(std::integral_constant<std::size_t, I>()), ...);
+    }(std::make_index_sequence<L.size()>());
+}
+
+/**
+ * Whether the characters at `p`, `p + step`, `p + 2 * step`, ... spell the
+ * literal. Stops at the first mismatch. All `L.size()` characters must be
+ * readable.
+ */
+template <Literal L>
+constexpr bool match(const char* p, std::ptrdiff_t step = 1)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return ((p[static_cast<std::ptrdiff_t>(I) * step] == L[I]) && ...);
+    }(std::make_index_sequence<L.size()>());
+}
+
+/**
+ * Whether `str` starts with the literal.
+ */
+template <Literal L>
+constexpr bool starts_with(std::string_view str)
+{
+    return str.size() >= L.size() && match<L>(str.data());
+}
+
+static_assert(match<"XMAS">("XMAS"));
+static_assert(match<"XMAS">("XXMMAASS", 2));
+static_assert(!starts_with<"do()">("do("));
+
+}  // namespace aoc
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * Size of a cache line. Values written by different threads are kept this far
+ * apart so that they never share a line.
+ */
+constexpr std::size_t CACHE_LINE = 64;
+
+/**
+ * Value padded to its own cache line(s).
+ */
+template <typename T>
+struct alignas(CACHE_LINE) Padded {
+    T value;
+};
+
+/**
+ * Fixed-size pool of threads that run batches of independent tasks.
+ *
+ * A batch of `num_tasks` tasks is handed out one task at a time from a shared
+ * counter, so threads that finish early take over the remaining tasks of
+ * slower threads. The calling thread works on the batch too, so a pool of `n`
+ * threads spawns `n - 1` workers.
+ *
+ * Only one batch runs at a time. A batch started from inside a task, or while
+ * another thread's batch is running, is run on the calling thread instead of
+ * waiting for the pool.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int num_threads)
+    {
+        assert(num_threads >= 1);
+        for (int i = 1; i < num_threads; ++i) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Number of threads, including the calling thread.
+     */
+    int num_threads() const { return workers.size() + 1; }
+
+    /**
+     * Call `fn(i)` for each `i` in `[0, num_tasks)`, and wait for all calls to
+     * finish. The calls may happen on any thread and in any order.
+     */
+    template <typename Fn>
+    void run(std::size_t num_tasks, Fn&& fn)
+    {
+        std::unique_lock batch_lock(batch_mutex, std::try_to_lock);
+        if (workers.empty() || num_tasks <= 1 || in_task() || !batch_lock.owns_lock()) {
+            for (std::size_t i = 0; i < num_tasks; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            task_fn = &fn;
+            call = [](void* fn, std::size_t i) { (*static_cast<Fn*>(fn))(i); };
+            batch_size = num_tasks;
+            next_task = 0;
+            num_busy = workers.size();
+            ++batch;
+        }
+        wake.notify_all();
+
+        drain();
+
+        std::unique_lock lock(mutex);
+        done.wait(lock, [this]() { return num_busy == 0; });
+    }
+
+private:
+    /**
+     * Whether the current thread is running a task of any pool.
+     */
+    static bool& in_task()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    /**
+     * Run tasks of the current batch until there are none left.
+     */
+    void drain()
+    {
+        in_task() = true;
+        for (std::size_t i = next_task++; i < batch_size; i = next_task++) {
+            call(task_fn, i);
+        }
+        in_task() = false;
+    }
+
+    void work()
+    {
+        std::size_t last_batch = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&]() { return stopping || batch != last_batch; });
+                if (stopping) {
+                    return;
+                }
+                last_batch = batch;
+            }
+
+            drain();
+
+            std::lock_guard lock(mutex);
+            if (--num_busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+
+    std::mutex batch_mutex;  // held by the thread running a batch
+
+    std::mutex mutex;  // guards the fields below, except `next_task`
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    std::size_t batch = 0;  // incremented for each new batch
+    std::size_t num_busy = 0;
+    void* task_fn = nullptr;
+    void (*call)(void*, std::size_t) = nullptr;
+    std::size_t batch_size = 0;
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> next_task = 0;
+};
+
+/**
+ * Requested number of threads for the default pool. 0 means one per core.
+ */
+inline int& requested_threads()
+{
+    static int num_threads = 0;
+    return num_threads;
+}
+
+/**
+ * Set the number of threads of the default pool. Must be called before the
+ * default pool is first used.
+ */
+inline void set_num_threads(int num_threads)
+{
+    assert(num_threads >= 0);
+    requested_threads() = num_threads;
+}
+
+/**
+ * Number of threads of the default pool.
+ */
+inline int num_threads()
+{
+    const int requested = requested_threads();
+    return requested > 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Whether the default pool has been created, i.e. its threads are running.
+ */
+inline bool& default_pool_started()
+{
+    static bool started = false;
+    return started;
+}
+
+/**
+ * Pool shared by all parallel algorithms. Created on first use.
+ */
+inline ThreadPool& default_pool()
+{
+    static ThreadPool pool = []() {
+        default_pool_started() = true;
+        return ThreadPool(num_threads());
+    }();
+    return pool;
+}
+
+/**
+ * Remove a `--threads N` or `--threads=N` flag from the command line
+ * arguments and set the number of threads of the default pool from it.
+ * @returns New argument count
+ */
+inline int parse_threads_flag(int argc, char** argv)
+{
+    int j = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            set_num_threads(std::atoi(argv[++i]));
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            set_num_threads(std::atoi(argv[i] + 10));
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    argv[j] = nullptr;
+    return j;
+}
+
+/**
+ * Call `fn(begin, end)` on consecutive chunks of `[0, n)` in parallel. Chunks
+ * have `grain` elements, except for the last one.
+ */
+template <typename Fn>
+void parallel_for(std::size_t n, std::size_t grain, Fn&& fn)
+{
+    assert(grain > 0);
+    const std::size_t num_chunks = (n + grain - 1) / grain;
+    default_pool().run(num_chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * grain;
+        fn(begin, std::min(begin + grain, n));
+    });
+}
+
+/**
+ * Reduce `[0, n)` in parallel. `map(begin, end)` reduces a chunk of `grain`
+ * elements to a value, and the values of the chunks are folded left to right
+ * into `init` with `combine(accumulated, value)`.
+ *
+ * The chunks only depend on `n` and `grain`, and are always combined in the
+ * same order, so the result does not depend on the number of threads even
+ * when `combine` is not associative.
+ */
+template <typename T, typename Map, typename Combine>
+T parallel_reduce(std::size_t n, std::size_t grain, T init, Map&& map, Combine&& combine)
+{
+    assert(grain > 0);
+    const std::size_t num_chunks = (n + grain - 1) / grain;
+    std::vector<Padded<T>> values(num_chunks);
+    default_pool().run(num_chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * grain;
+        values[chunk].value = map(begin, std::min(begin + grain, n));
+    });
+
+    for (auto& value : values) {
+        init = combine(std::move(init), std::move(value.value));
+    }
+    return init;
+}
+
+}  // namespace aoc
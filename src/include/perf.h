@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace aoc::perf
+{
+
+/**
+ * Hardware events that can be counted.
+ */
+enum Event { cycles, instructions, l1d_misses, llc_misses, branch_misses, NUM_EVENTS };
+
+inline const char* to_string(Event event)
+{
+    switch (event) {
+        case cycles:
+            return "cycles";
+        case instructions:
+            return "instructions";
+        case l1d_misses:
+            return "l1d_misses";
+        case llc_misses:
+            return "llc_misses";
+        default:
+            return "branch_misses";
+    }
+}
+
+/**
+ * Counts of each event. An event that could not be counted is marked invalid.
+ */
+struct Counts {
+    std::array<double, NUM_EVENTS> values{};
+    std::array<bool, NUM_EVENTS> valid{};
+
+    bool any_valid() const
+    {
+        for (const bool v : valid) {
+            if (v) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Counts& operator+=(const Counts& other)
+    {
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+};
+
+/**
+ * Hardware performance counters of the calling thread, using Linux
+ * `perf_event_open`. Only user-space events are counted, which unprivileged
+ * processes are usually allowed to do.
+ *
+ * Events that cannot be opened, e.g. in a VM without a virtual PMU, on other
+ * platforms, or when perf events are disabled, are left out, so the counters
+ * degrade to counting nothing rather than failing.
+ *
+ * Threads started by the calling thread after the counters are opened, such
+ * as those of a thread pool created later, are counted too. Work done on
+ * threads that were already running is not.
+ */
+class Counters
+{
+public:
+    Counters()
+    {
+        fds.fill(-1);
+#if defined(__linux__)
+        const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds[cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[l1d_misses] = open(PERF_TYPE_HW_CACHE, l1d_read_miss);
+        fds[llc_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[branch_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    ~Counters()
+    {
+#if defined(__linux__)
+        for (const int fd : fds) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    Counters(const Counters&) = delete;
+    Counters& operator=(const Counters&) = delete;
+
+    /**
+     * Whether any event can be counted.
+     */
+    bool available() const
+    {
+        for (const int fd : fds) {
+            if (fd != -1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Reset the counters and start counting.
+     */
+    void start()
+    {
+#if defined(__linux__)
+        for (const int fd : fds) {
+            if (fd != -1) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * Stop counting, and return the counts since `start`.
+     */
+    Counts stop()
+    {
+        Counts counts;
+#if defined(__linux__)
+        for (const int fd : fds) {
+            if (fd != -1) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            // value, time enabled, time running. when there are more events
+            // than hardware counters, the kernel multiplexes them, and the
+            // value is scaled up to the whole time enabled
+            uint64_t data[3];
+            if (fds[i] != -1 && read(fds[i], data, sizeof(data)) == sizeof(data) && data[2] > 0) {
+                counts.values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+                counts.valid[i] = true;
+            }
+        }
+#endif
+        return counts;
+    }
+
+private:
+#if defined(__linux__)
+    static int open(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;  // also count threads started later
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        return fd < 0 ? -1 : static_cast<int>(fd);
+    }
+#endif
+
+    std::array<int, NUM_EVENTS> fds;
+};
+
+/**
+ * Counts events for as long as it is alive, and adds them to `total` when it
+ * goes out of scope.
+ */
+class Scope
+{
+public:
+    Scope(Counters& counters, Counts& total) : counters(counters), total(total) { counters.start(); }
+    ~Scope() { total += counters.stop(); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Counters& counters;
+    Counts& total;
+};
+
+}  // namespace aoc::perf
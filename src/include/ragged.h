@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cassert>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * Ragged 2D array, i.e. a list of rows of varying length. All values are
+ * stored in a single contiguous buffer, with an array of offsets marking
+ * where each row starts (compressed sparse row layout).
+ *
+ * Both buffers are allocated from a `std::pmr` memory resource, such as an
+ * arena.
+ */
+template <typename T>
+class Ragged
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::span<const T>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const Ragged* ragged, std::size_t i) : ragged(ragged), i(i) {}
+
+        value_type operator*() const { return (*ragged)[i]; }
+
+        iterator& operator++()
+        {
+            ++i;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++i;
+            return tmp;
+        }
+
+        difference_type operator-(const iterator& other) const { return i - other.i; }
+        bool operator==(const iterator& other) const { return i == other.i; }
+
+    private:
+        const Ragged* ragged = nullptr;
+        std::size_t i = 0;
+    };
+
+    explicit Ragged(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : values(resource), offsets(1, 0, resource)
+    {
+    }
+
+    /**
+     * Number of rows.
+     */
+    std::size_t size() const { return offsets.size() - 1; }
+
+    /**
+     * Total number of values over all rows.
+     */
+    std::size_t num_values() const { return values.size(); }
+
+    std::span<const T> operator[](std::size_t i) const
+    {
+        assert(i < size());
+        return std::span<const T>(values.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+
+    /**
+     * Append a value to the row currently being built.
+     */
+    void push_back(T value) { values.push_back(value); }
+
+    /**
+     * Finish the row currently being built.
+     */
+    void end_row() { offsets.push_back(values.size()); }
+
+    /**
+     * Finish a row that ends after the first `num_values` values. This allows
+     * rows to be ended after some of the values of the next row are appended.
+     */
+    void end_row(std::size_t num_values)
+    {
+        assert(num_values >= offsets.back());
+        offsets.push_back(num_values);
+    }
+
+    /**
+     * Append a whole row.
+     */
+    void push_row(std::span<const T> row)
+    {
+        values.insert(values.end(), row.begin(), row.end());
+        end_row();
+    }
+
+    /**
+     * Remove all rows, keeping the buffers for reuse.
+     */
+    void clear()
+    {
+        values.clear();
+        offsets.resize(1);
+    }
+
+    void reserve(std::size_t num_rows, std::size_t num_values)
+    {
+        offsets.reserve(num_rows + 1);
+        values.reserve(num_values);
+    }
+
+private:
+    std::pmr::vector<T> values;
+    std::pmr::vector<std::size_t> offsets;
+};
+
+}  // namespace aoc
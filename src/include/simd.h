@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__)
+    #include <immintrin.h>
+#endif
+
+namespace aoc::simd
+{
+
+/**
+ * Instruction set levels that kernels can be specialized for. Kernels are
+ * compiled for every level and the best one supported by the CPU is chosen at
+ * runtime, so the binary itself does not require any extensions.
+ */
+enum class Level { scalar, sse42, avx2 };
+
+/**
+ * Best level supported by the CPU we are running on.
+ */
+inline Level best_level()
+{
+#if defined(__x86_64__)
+    static const Level level = __builtin_cpu_supports("avx2")     ? Level::avx2
+                               : __builtin_cpu_supports("sse4.2") ? Level::sse42
+                                                                  : Level::scalar;
+    return level;
+#else
+    return Level::scalar;
+#endif
+}
+
+inline const char* to_string(Level level)
+{
+    switch (level) {
+        case Level::avx2:
+            return "avx2";
+        case Level::sse42:
+            return "sse4.2";
+        default:
+            return "scalar";
+    }
+}
+
+#if defined(__x86_64__)
+
+/**
+ * Vector of 16 bytes, using SSE4.2. Functions using it must be compiled with
+ * `__attribute__((target("sse4.2")))`.
+ */
+struct Sse42Bytes {
+    using Reg = __m128i;
+    static constexpr int WIDTH = 16;
+
+    __attribute__((target("sse4.2"))) static Reg load(const char* p)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    __attribute__((target("sse4.2"))) static Reg splat(char c) { return _mm_set1_epi8(c); }
+    __attribute__((target("sse4.2"))) static Reg eq(Reg a, Reg b) { return _mm_cmpeq_epi8(a, b); }
+    __attribute__((target("sse4.2"))) static Reg gt(Reg a, Reg b) { return _mm_cmpgt_epi8(a, b); }
+    __attribute__((target("sse4.2"))) static Reg bit_and(Reg a, Reg b) { return _mm_and_si128(a, b); }
+    __attribute__((target("sse4.2"))) static Reg bit_or(Reg a, Reg b) { return _mm_or_si128(a, b); }
+
+    /**
+     * Bitmask of the most significant bit of each byte.
+     */
+    __attribute__((target("sse4.2"))) static uint32_t mask(Reg a) { return _mm_movemask_epi8(a); }
+};
+
+/**
+ * Vector of 32 bytes, using AVX2. Functions using it must be compiled with
+ * `__attribute__((target("avx2")))`.
+ */
+struct Avx2Bytes {
+    using Reg = __m256i;
+    static constexpr int WIDTH = 32;
+
+    __attribute__((target("avx2"))) static Reg load(const char* p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    __attribute__((target("avx2"))) static Reg splat(char c) { return _mm256_set1_epi8(c); }
+    __attribute__((target("avx2"))) static Reg eq(Reg a, Reg b) { return _mm256_cmpeq_epi8(a, b); }
+    __attribute__((target("avx2"))) static Reg gt(Reg a, Reg b) { return _mm256_cmpgt_epi8(a, b); }
+    __attribute__((target("avx2"))) static Reg bit_and(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+    __attribute__((target("avx2"))) static Reg bit_or(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+
+    /**
+     * Bitmask of the most significant bit of each byte.
+     */
+    __attribute__((target("avx2"))) static uint32_t mask(Reg a) { return _mm256_movemask_epi8(a); }
+};
+
+#endif
+
+}  // namespace aoc::simd
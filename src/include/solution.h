@@ -0,0 +1,389 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "bench.h"
+#include "external_sort.h"
+#include "io.h"
+#include "parallel.h"
+#include "perf.h"
+
+namespace aoc
+{
+
+/**
+ * Solution to a day's puzzle, split into stages:
+ *
+ * 1. `parse` reads the input into the solution's own data structures.
+ * 2. `prepare` computes intermediate results that both parts need, such as
+ *    sorted lists, so that they are computed only once.
+ * 3. `part1` and `part2` compute the answers from the prepared state. They do
+ *    not modify the solution, so they can run concurrently.
+ *
+ * The solution allocates its data structures from `resource()`, usually an
+ * `Arena`, so that parsing does not allocate per line.
+ */
+class Solution
+{
+public:
+    explicit Solution(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : memory(resource) {}
+
+    virtual ~Solution() = default;
+
+    std::pmr::memory_resource* resource() const { return memory; }
+
+    /**
+     * Parse the input. The input is only valid during the call, so the
+     * solution must not keep references into it.
+     */
+    virtual void parse(std::string_view input) = 0;
+
+    /**
+     * Parse the input file, or stdin if `filename` is "-". By default, the
+     * whole file is read into memory and passed to `parse`.
+     */
+    virtual void parse_file(const char* filename)
+    {
+        const Input input(filename);
+        parse(input.view());
+    }
+
+    virtual void prepare() {}
+
+    virtual long long part1() const = 0;
+    virtual long long part2() const = 0;
+
+    /**
+     * Problems with the input found by the last run of the parts, e.g. parts
+     * of it that had to be skipped. They are reported once, after the answers,
+     * rather than by the parts, which may run many times.
+     */
+    virtual std::vector<std::string> warnings() const { return {}; }
+
+private:
+    std::pmr::memory_resource* memory;
+};
+
+struct Answers {
+    long long part1 = 0;
+    long long part2 = 0;
+};
+
+/**
+ * Compute both parts of a prepared solution concurrently.
+ */
+inline Answers solve_parts(const Solution& solution)
+{
+    Answers answers;
+    {
+        std::jthread part2_thread([&]() { answers.part2 = solution.part2(); });
+        answers.part1 = solution.part1();
+    }
+    return answers;
+}
+
+/**
+ * Run all stages of a solution on an input file.
+ */
+inline Answers solve(Solution& solution, const char* filename)
+{
+    solution.parse_file(filename);
+    solution.prepare();
+    return solve_parts(solution);
+}
+
+inline void print_answers(int day, const Answers& answers)
+{
+    printf("Day %d Part 1: %lld\n", day, answers.part1);
+    printf("Day %d Part 2: %lld\n", day, answers.part2);
+}
+
+inline void print_warnings(int day, const std::vector<std::string>& warnings)
+{
+    for (const auto& warning : warnings) {
+        fprintf(stderr, "Day %d: %s\n", day, warning.c_str());
+    }
+}
+
+/**
+ * Options shared by every day's binary and the runner.
+ */
+struct RunOptions {
+    int bench_reps = 0;  // if positive, benchmark each stage this many times
+    int warmup_reps = 1;
+    bool json = false;  // print benchmark results as JSON, one object per day
+};
+
+/**
+ * Remove the `--threads N`, `--bench N`, `--json` and `--memory BYTES` flags
+ * from the command line arguments, and apply them. BYTES may have a K, M or G
+ * suffix.
+ * @returns New argument count
+ */
+inline int parse_run_options(int argc, char** argv, RunOptions& options)
+{
+    argc = parse_threads_flag(argc, argv);
+
+    int j = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            options.bench_reps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            options.json = true;
+        } else if (std::strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+            std::size_t budget;
+            if (!parse_size(argv[++i], budget) || budget == 0) {
+                fprintf(stderr, "Invalid memory budget '%s'\n", argv[i]);
+                std::exit(1);
+            }
+            set_memory_budget(budget);
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    argv[j] = nullptr;
+    return j;
+}
+
+/**
+ * Stages of a solution, in the order they run.
+ */
+enum Stage { parse_stage, prepare_stage, part1_stage, part2_stage, NUM_STAGES };
+
+inline const char* to_string(Stage stage)
+{
+    static const char* const NAMES[] = {"parse", "prepare", "part1", "part2"};
+    return NAMES[stage];
+}
+
+/**
+ * Measurements of one stage over repeated runs of a solution.
+ */
+struct StageResults {
+    std::vector<double> seconds;  // wall time of each repetition
+    perf::Counts counts;          // hardware events, summed over all repetitions
+};
+
+using BenchResults = std::array<StageResults, NUM_STAGES>;
+
+/**
+ * Whether hardware counters opened now would count the work of every thread
+ * of the pool. Counters are inherited only by threads started after them.
+ */
+inline bool pool_counted()
+{
+    return num_threads() == 1 || !default_pool_started();
+}
+
+/**
+ * Benchmark a solution on an input. Every stage is run and measured once per
+ * repetition, and the parts run one after the other so that they are measured
+ * alone. The first `warmup_reps` repetitions are not measured.
+ *
+ * Besides wall time, hardware events of each stage are counted when perf
+ * events are available. They include the threads of the pool only if it is
+ * started after the counters are opened, see `pool_counted`.
+ */
+inline BenchResults bench_stages(Solution& solution, std::string_view input, const RunOptions& options, Answers& answers)
+{
+    perf::Counters counters;
+    BenchResults results;
+    for (int i = 0; i < options.warmup_reps + options.bench_reps; ++i) {
+        std::array<double, NUM_STAGES> seconds;
+        std::array<perf::Counts, NUM_STAGES> counts;
+        const auto run_stage = [&](Stage stage, auto&& fn) {
+            const perf::Scope scope(counters, counts[stage]);
+            seconds[stage] = bench::wall_time(fn);
+        };
+
+        run_stage(parse_stage, [&]() { solution.parse(input); });
+        run_stage(prepare_stage, [&]() { solution.prepare(); });
+        run_stage(part1_stage, [&]() { answers.part1 = solution.part1(); });
+        run_stage(part2_stage, [&]() { answers.part2 = solution.part2(); });
+        // the answers are printed in the end, but make sure that every
+        // repetition computes them
+        bench::do_not_optimize(answers);
+
+        if (i >= options.warmup_reps) {
+            for (int stage = 0; stage < NUM_STAGES; ++stage) {
+                results[stage].seconds.push_back(seconds[stage]);
+                results[stage].counts += counts[stage];
+            }
+        }
+    }
+    return results;
+}
+
+/**
+ * Print the statistics of each stage, as tables or as a JSON object. Event
+ * counts are averaged over the repetitions.
+ */
+inline void print_bench(int day,
+                        std::size_t input_bytes,
+                        const Answers& answers,
+                        const BenchResults& results,
+                        bool all_threads_counted,
+                        bool json)
+{
+    const std::size_t reps = results[0].seconds.size();
+
+    if (json) {
+        printf("{\"day\": %d, \"input_bytes\": %zu, \"reps\": %zu, \"part1\": %lld, \"part2\": %lld, \"stages\": {", day,
+               input_bytes, reps, answers.part1, answers.part2);
+        for (int stage = 0; stage < NUM_STAGES; ++stage) {
+            const auto& result = results[stage];
+            const auto stats = bench::summarize(result.seconds);
+            printf("%s\"%s\": {\"min_ms\": %.6f, \"median_ms\": %.6f, \"p99_ms\": %.6f, \"mb_per_s\": %.3f",
+                   stage == 0 ? "" : ", ", to_string(Stage(stage)), 1e3 * stats.min, 1e3 * stats.median,
+                   1e3 * stats.p99, input_bytes / stats.median / 1e6);
+            if (result.counts.any_valid()) {
+                printf(", \"counters\": {");
+                bool first = true;
+                for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+                    if (result.counts.valid[event]) {
+                        printf("%s\"%s\": %.0f", first ? "" : ", ", perf::to_string(perf::Event(event)),
+                               result.counts.values[event] / reps);
+                        first = false;
+                    }
+                }
+                printf(", \"all_threads\": %s}", all_threads_counted ? "true" : "false");
+            }
+            printf("}");
+        }
+        printf("}}\n");
+        return;
+    }
+
+    print_answers(day, answers);
+    printf("%-8s %12s %12s %12s %12s\n", "stage", "min ms", "median ms", "p99 ms", "MB/s");
+    for (int stage = 0; stage < NUM_STAGES; ++stage) {
+        const auto stats = bench::summarize(results[stage].seconds);
+        printf("%-8s %12.3f %12.3f %12.3f %12.1f\n", to_string(Stage(stage)), 1e3 * stats.min, 1e3 * stats.median,
+               1e3 * stats.p99, input_bytes / stats.median / 1e6);
+    }
+
+    if (!results[0].counts.any_valid()) {
+        printf("(hardware counters unavailable, timing only)\n");
+        return;
+    }
+    printf("%-8s", "stage");
+    for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+        printf(" %14s", perf::to_string(perf::Event(event)));
+    }
+    printf(" %6s\n", "IPC");
+    for (int stage = 0; stage < NUM_STAGES; ++stage) {
+        const auto& counts = results[stage].counts;
+        printf("%-8s", to_string(Stage(stage)));
+        for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+            if (counts.valid[event]) {
+                printf(" %14.0f", counts.values[event] / reps);
+            } else {
+                printf(" %14s", "-");
+            }
+        }
+        if (counts.valid[perf::cycles] && counts.valid[perf::instructions] && counts.values[perf::cycles] > 0) {
+            printf(" %6.2f\n", counts.values[perf::instructions] / counts.values[perf::cycles]);
+        } else {
+            printf(" %6s\n", "-");
+        }
+    }
+    if (!all_threads_counted) {
+        printf("(counts of the calling thread only, the other %d threads of the pool started before the counters)\n",
+               num_threads() - 1);
+    }
+}
+
+/**
+ * Run a solution on an input file, and print either the answers or, if asked
+ * to, benchmark results.
+ */
+inline void run_day(int day, Solution& solution, const char* filename, const RunOptions& options)
+{
+    if (options.bench_reps <= 0) {
+        print_answers(day, solve(solution, filename));
+        print_warnings(day, solution.warnings());
+        return;
+    }
+
+    const Input input(filename);
+    Answers answers;
+    const bool all_threads_counted = pool_counted();
+    const BenchResults results = bench_stages(solution, input.view(), options, answers);
+    print_bench(day, input.view().size(), answers, results, all_threads_counted, options.json);
+    print_warnings(day, solution.warnings());
+}
+
+/**
+ * Entry point of a single day's binary, which takes the input file and
+ * optional `--threads`, `--bench`, `--json` and `--memory` flags.
+ */
+template <typename S>
+int run_main(int day, int argc, char** argv)
+{
+    RunOptions options;
+    argc = parse_run_options(argc, argv, options);
+    assert(argc == 2);
+    const char* filename = argv[1];
+
+    Arena arena;
+    S solution(arena.resource());
+    run_day(day, solution, filename, options);
+
+    return 0;
+}
+
+/**
+ * Day registered with `AOC_REGISTER`, with a function creating its solution
+ * that allocates from a memory resource.
+ */
+struct RegisteredDay {
+    int day;
+    std::unique_ptr<Solution> (*make)(std::pmr::memory_resource*);
+};
+
+/**
+ * All registered days, in no particular order.
+ */
+inline std::vector<RegisteredDay>& registry()
+{
+    static std::vector<RegisteredDay> days;
+    return days;
+}
+
+/**
+ * Adds a day to the registry when constructed. Used by `AOC_REGISTER`.
+ */
+struct Registrar {
+    Registrar(int day, std::unique_ptr<Solution> (*make)(std::pmr::memory_resource*))
+    {
+        registry().push_back({day, make});
+    }
+};
+
+}  // namespace aoc
+
+/**
+ * Register solution class `S` for day `day` with the `aoc` runner. Only has an
+ * effect when compiled for the runner, i.e. with `AOC_RUNNER` defined.
+ */
+#ifdef AOC_RUNNER
+    #define AOC_REGISTER(S, day)                                                                 \
+        static const aoc::Registrar aoc_registrar_##S(day, [](std::pmr::memory_resource* resource) { \
+            return std::unique_ptr<aoc::Solution>(std::make_unique<S>(resource));                    \
+        })
+#else
+    #define AOC_REGISTER(S, day)
+#endif
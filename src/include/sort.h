@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aoc
+{
+
+namespace detail
+{
+
+/**
+ * Sort values in `[min, min + range)` by counting the occurrences of each
+ * value and writing them back in order.
+ */
+inline void counting_sort(std::span<int> values, int min, uint32_t range)
+{
+    std::vector<uint32_t> counts(range, 0);
+    for (const int x : values) {
+        ++counts[static_cast<uint32_t>(x) - static_cast<uint32_t>(min)];
+    }
+
+    auto out = values.begin();
+    for (uint32_t i = 0; i < range; ++i) {
+        out = std::fill_n(out, counts[i], static_cast<int>(static_cast<uint32_t>(min) + i));
+    }
+}
+
+/**
+ * LSD radix sort of values in `[min, min + range)`, one byte of the offset
+ * from `min` at a time. Only as many bytes as `range` needs are sorted.
+ */
+inline void radix_sort(std::span<int> values, int min, uint32_t range)
+{
+    int num_passes = 1;
+    while (num_passes < 4 && (range - 1) >> (8 * num_passes) != 0) {
+        ++num_passes;
+    }
+
+    std::vector<uint32_t> keys(values.size());
+    std::vector<uint32_t> sorted(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        keys[i] = static_cast<uint32_t>(values[i]) - static_cast<uint32_t>(min);
+    }
+
+    for (int pass = 0; pass < num_passes; ++pass) {
+        const int shift = 8 * pass;
+
+        std::array<std::size_t, 256> offsets{};
+        for (const uint32_t key : keys) {
+            ++offsets[(key >> shift) & 0xff];
+        }
+        std::size_t total = 0;
+        for (auto& offset : offsets) {
+            const std::size_t count = offset;
+            offset = total;
+            total += count;
+        }
+
+        for (const uint32_t key : keys) {
+            sorted[offsets[(key >> shift) & 0xff]++] = key;
+        }
+        keys.swap(sorted);
+    }
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>(keys[i] + static_cast<uint32_t>(min));
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Sort integers in ascending order, choosing a strategy from the range of the
+ * values: a counting sort when the range is not much larger than the number
+ * of values, and otherwise an LSD radix sort over the bytes the range needs.
+ * Short inputs fall back to `std::sort`.
+ */
+inline void sort_ints(std::span<int> values)
+{
+    if (values.size() < 256) {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    const auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    const int min = *min_it;
+    const int max = *max_it;
+    // the range of 32-bit values can be 2^32, which overflows; 0 stands in for it
+    const uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1;
+
+    if (range != 0 && range <= 4 * values.size()) {
+        detail::counting_sort(values, min, range);
+    } else {
+        detail::radix_sort(values, min, range);
+    }
+}
+
+}  // namespace aoc